@@ -0,0 +1,302 @@
+#include "allocation.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the classes.
+ */
+
+/*
+ * This is the implementation of allocation.h. With PLAN_TRACK_ALLOCATIONS
+ * defined, every global operator new and delete goes through allocate and
+ * release below; without it the counters never move and the file only keeps
+ * the interface linkable.
+ *
+ * Implementation Invariant:
+ * Every tracked block starts with a HEADER holding the requested size, so
+ * delete knows how many bytes to take off the live count. Each thread keeps
+ * running counters; a scope copies them when it starts and records the
+ * difference when it ends, which makes nested scopes inclusive without any
+ * per-allocation bookkeeping beyond a few additions. The thread peak is
+ * lowered to the live bytes when a scope starts and raised back to the
+ * enclosing peak when it ends. Allocations made by the tracker itself (the
+ * summary map) are left out of the thread counters.
+ *
+ * Error Processing:
+ * The counting operator new throws std::bad_alloc like the standard one, and
+ * the nothrow forms return nullptr.
+ *
+ * Assumptions:
+ * Over-aligned types (alignas above alignof(std::max_align_t)) use the
+ * standard aligned operator new and are not counted. Memory freed by another
+ * thread than the one that allocated it lowers the live bytes of the freeing
+ * thread.
+ */
+
+namespace
+{
+    // running counters of one thread
+    struct Counters
+    {
+        unsigned long long allocations;
+        unsigned long long frees;
+        unsigned long long bytes;
+        long long live;
+        long long peak;
+    };
+
+    thread_local Counters counters = { 0, 0, 0, 0, 0 };
+
+    // set while the tracker allocates for itself
+    thread_local bool internal = false;
+
+    std::atomic<long long> processLive(0);
+    std::atomic<long long> processPeak(0);
+
+    // holds the summary by call site
+    std::mutex summaryLock;
+
+    std::map<std::string, AllocationStats>& sites()
+    {
+        static std::map<std::string, AllocationStats>* table =
+                new std::map<std::string, AllocationStats>();
+        return *table;
+    }
+}
+
+#ifdef PLAN_TRACK_ALLOCATIONS
+
+namespace
+{
+    // room before each block for its size, keeping the block aligned
+    const std::size_t HEADER = alignof(std::max_align_t);
+
+    // raises peak to at least value
+    void raise(std::atomic<long long>& peak, long long value)
+    {
+        long long seen = peak.load(std::memory_order_relaxed);
+        while (seen < value &&
+               !peak.compare_exchange_weak(seen, value,
+                                           std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void* allocate(std::size_t size)
+    {
+        char* block = static_cast<char*>(std::malloc(size + HEADER));
+        if (block == nullptr)
+            return nullptr;
+
+        *reinterpret_cast<std::size_t*>(block) = size;
+
+        const long long amount = static_cast<long long>(size);
+        if (!internal)
+        {
+            counters.allocations++;
+            counters.bytes += size;
+            counters.live += amount;
+            if (counters.live > counters.peak)
+                counters.peak = counters.live;
+        }
+        raise(processPeak, processLive.fetch_add
+                (amount, std::memory_order_relaxed) + amount);
+
+        return block + HEADER;
+    }
+
+    void release(void* pointer)
+    {
+        if (pointer == nullptr)
+            return;
+
+        char* block = static_cast<char*>(pointer) - HEADER;
+        const long long amount =
+                static_cast<long long>(*reinterpret_cast<std::size_t*>(block));
+
+        if (!internal)
+        {
+            counters.frees++;
+            counters.live -= amount;
+        }
+        processLive.fetch_sub(amount, std::memory_order_relaxed);
+
+        std::free(block);
+    }
+
+    void* allocateOrThrow(std::size_t size)
+    {
+        void* pointer = allocate(size);
+        if (pointer == nullptr)
+            throw std::bad_alloc();
+        return pointer;
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+#endif // PLAN_TRACK_ALLOCATIONS
+
+// Allocation scope constructor
+AllocationScope::AllocationScope(const char* site)
+        : site(site), allocations(counters.allocations),
+          frees(counters.frees), bytes(counters.bytes), live(counters.live),
+          outerPeak(counters.peak)
+{
+    counters.peak = counters.live;
+}
+
+// Allocation scope destructor
+AllocationScope::~AllocationScope()
+{
+    const AllocationStats stats = current();
+
+    if (counters.peak < outerPeak)
+        counters.peak = outerPeak;
+
+    internal = true;
+    {
+        std::lock_guard<std::mutex> lock(summaryLock);
+        AllocationStats& total = sites()[site];
+        total.calls++;
+        total.allocations += stats.allocations;
+        total.frees += stats.frees;
+        total.bytes += stats.bytes;
+        if (stats.peakBytes > total.peakBytes)
+            total.peakBytes = stats.peakBytes;
+    }
+    internal = false;
+}
+
+// Allocation scope current function
+AllocationStats AllocationScope::current() const
+{
+    return AllocationStats{ 1, counters.allocations - allocations,
+                            counters.frees - frees, counters.bytes - bytes,
+                            counters.peak - live };
+}
+
+// Enabled function
+bool AllocationTracker::enabled()
+{
+#ifdef PLAN_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Summary function
+std::map<std::string, AllocationStats> AllocationTracker::summary()
+{
+    std::lock_guard<std::mutex> lock(summaryLock);
+    return sites();
+}
+
+// Live bytes function
+long long AllocationTracker::liveBytes()
+{
+    return processLive.load(std::memory_order_relaxed);
+}
+
+// Peak bytes function
+long long AllocationTracker::peakBytes()
+{
+    return processPeak.load(std::memory_order_relaxed);
+}
+
+// Report function
+void AllocationTracker::report(std::ostream& os)
+{
+    const std::map<std::string, AllocationStats> table = summary();
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize precision = os.precision();
+
+    os << std::left << std::setw(24) << "SITE" << std::right
+       << std::setw(10) << "CALLS" << std::setw(12) << "ALLOCS"
+       << std::setw(12) << "ALLOCS/CALL" << std::setw(14) << "BYTES"
+       << std::setw(12) << "PEAK" << std::endl;
+
+    for (const auto& site : table)
+    {
+        const AllocationStats& stats = site.second;
+        os << std::left << std::setw(24) << site.first << std::right
+           << std::setw(10) << stats.calls << std::setw(12) << stats.allocations
+           << std::setw(12) << std::fixed << std::setprecision(1)
+           << static_cast<double>(stats.allocations) / stats.calls
+           << std::setw(14) << stats.bytes << std::setw(12) << stats.peakBytes
+           << std::endl;
+    }
+
+    os << "PROCESS PEAK: " << peakBytes() << " bytes, LIVE: " << liveBytes()
+       << " bytes" << std::endl;
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+// Reset function
+void AllocationTracker::reset()
+{
+    internal = true;
+    {
+        std::lock_guard<std::mutex> lock(summaryLock);
+        sites().clear();
+    }
+    internal = false;
+
+    processPeak.store(processLive.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+}
@@ -0,0 +1,138 @@
+#ifndef ALLOCATION_H
+#define ALLOCATION_H
+
+#include <map>
+#include <ostream>
+#include <string>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the classes.
+ */
+
+/*
+ * Allocation accounting is opt-in: build with -DPLAN_TRACK_ALLOCATIONS to
+ * replace the global operator new and delete with counting versions. In a
+ * normal build ALLOCATION_SCOPE expands to nothing and every count is zero.
+ */
+
+/// <summary>
+/// Allocation counts of a scope or call site. Counts are inclusive: they
+/// cover everything allocated until the scope ends, nested scopes included.
+/// </summary>
+struct AllocationStats
+{
+    unsigned long long calls;           // scopes recorded
+    unsigned long long allocations;     // operator new calls
+    unsigned long long frees;           // operator delete calls
+    unsigned long long bytes;           // bytes requested
+    long long peakBytes;                // highest live bytes above the start
+};
+
+/// <summary>
+/// Class representing one instrumented operation (RAII).
+/// Creating a scope starts counting on the current thread; destroying it
+/// adds the counts to the summary of its call site.
+/// Class Invariant: Scopes on a thread end in the reverse order they start.
+/// </summary>
+class AllocationScope
+{
+private:
+    const char* site;                   // call site name (not owned)
+    unsigned long long allocations;     // thread counters at the start
+    unsigned long long frees;
+    unsigned long long bytes;
+    long long live;                     // thread live bytes at the start
+    long long outerPeak;                // thread peak before the start
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: site must be a string that outlives the program
+    /// (normally a literal).
+    /// Postcondition: Counting for site starts on this thread.
+    /// </summary>
+    explicit AllocationScope(const char* site);
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    /// <summary>
+    /// Destructor
+    /// Precondition: None.
+    /// Postcondition: The counts of the scope are added to its site.
+    /// </summary>
+    ~AllocationScope();
+
+    /// <summary>
+    /// Current function
+    /// Precondition: None.
+    /// Postcondition: The counts since the scope started are returned, so a
+    /// test can assert that a hot path doesn't allocate.
+    /// </summary>
+    AllocationStats current() const;
+};
+
+/// <summary>
+/// Class representing the process-wide allocation summary.
+/// Class Invariant: None (the class only has static functions).
+/// </summary>
+class AllocationTracker
+{
+public:
+    /// <summary>
+    /// Enabled function
+    /// Precondition: None.
+    /// Postcondition: true is returned if the build counts allocations.
+    /// </summary>
+    static bool enabled();
+
+    /// <summary>
+    /// Summary function
+    /// Precondition: None.
+    /// Postcondition: The counts of every call site so far are returned, by
+    /// site name.
+    /// </summary>
+    static std::map<std::string, AllocationStats> summary();
+
+    /// <summary>
+    /// Live Bytes function
+    /// Precondition: None.
+    /// Postcondition: The bytes currently allocated by the process are
+    /// returned.
+    /// </summary>
+    static long long liveBytes();
+
+    /// <summary>
+    /// Peak Bytes function
+    /// Precondition: None.
+    /// Postcondition: The highest live bytes since start or reset() are
+    /// returned.
+    /// </summary>
+    static long long peakBytes();
+
+    /// <summary>
+    /// Report function
+    /// Precondition: None.
+    /// Postcondition: A table of the summary and the process peak is written
+    /// to os.
+    /// </summary>
+    static void report(std::ostream& os);
+
+    /// <summary>
+    /// Reset function
+    /// Precondition: No scope is active.
+    /// Postcondition: The summary is cleared and the peak restarts at the
+    /// live bytes.
+    /// </summary>
+    static void reset();
+};
+
+#ifdef PLAN_TRACK_ALLOCATIONS
+#define ALLOCATION_CONCAT(a, b) a##b
+#define ALLOCATION_NAME(line) ALLOCATION_CONCAT(allocationScope, line)
+#define ALLOCATION_SCOPE(site) AllocationScope ALLOCATION_NAME(__LINE__)(site)
+#else
+#define ALLOCATION_SCOPE(site) ((void)0)
+#endif
+
+#endif // !ALLOCATION_H
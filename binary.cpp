@@ -0,0 +1,131 @@
+// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the classes.
+ */
+
+/*
+ * This is the implementation of binary.h. BinaryWriter appends fixed-size
+ * values and length-prefixed strings to one buffer, and BinaryReader reads
+ * them back in the same order.
+ *
+ * Implementation Invariant:
+ * Values are copied with memcpy, so they are stored in the host byte order
+ * with no padding, and reading copies them back the same way.
+ *
+ * Error Processing:
+ * BinaryReader throws an std::out_of_range exception if a read would pass
+ * the end of the data, so a truncated buffer is never read past its end.
+ *
+ * Assumptions:
+ * Buffers are read on a host with the same byte order as the writer
+ * (little-endian on every supported platform).
+ */
+
+#include "binary.h"
+#include <cstring>
+#include <stdexcept>
+
+void BinaryWriter::reserve(std::size_t bytes)
+{
+    buffer.reserve(bytes);
+}
+
+void BinaryWriter::writeBytes(const void* data, std::size_t bytes)
+{
+    buffer.append(static_cast<const char*>(data), bytes);
+}
+
+void BinaryWriter::writeInt(int value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void BinaryWriter::writeLong(long long value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void BinaryWriter::writeUnsigned(unsigned long long value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void BinaryWriter::writeDouble(double value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void BinaryWriter::writeString(const std::string& value)
+{
+    writeInt(static_cast<int>(value.size()));
+    writeBytes(value.data(), value.size());
+}
+
+const std::string& BinaryWriter::getBuffer() const
+{
+    return buffer;
+}
+
+std::string BinaryWriter::takeBuffer()
+{
+    std::string taken;
+    taken.swap(buffer);
+    return taken;
+}
+
+BinaryReader::BinaryReader(const char* data, std::size_t size)
+        : data(data), size(size), position(0)
+{
+}
+
+void BinaryReader::readBytes(void* out, std::size_t bytes)
+{
+    if (bytes > size - position)
+        throw std::out_of_range("read failed. Not enough data.");
+
+    std::memcpy(out, data + position, bytes);
+    position += bytes;
+}
+
+int BinaryReader::readInt()
+{
+    int value;
+    readBytes(&value, sizeof(value));
+    return value;
+}
+
+long long BinaryReader::readLong()
+{
+    long long value;
+    readBytes(&value, sizeof(value));
+    return value;
+}
+
+unsigned long long BinaryReader::readUnsigned()
+{
+    unsigned long long value;
+    readBytes(&value, sizeof(value));
+    return value;
+}
+
+double BinaryReader::readDouble()
+{
+    double value;
+    readBytes(&value, sizeof(value));
+    return value;
+}
+
+std::string BinaryReader::readString()
+{
+    int length = readInt();
+    if (length < 0 || static_cast<std::size_t>(length) > remaining())
+        throw std::out_of_range("read failed. Not enough data.");
+
+    std::string value(data + position, length);
+    position += length;
+    return value;
+}
+
+std::size_t BinaryReader::remaining() const
+{
+    return size - position;
+}
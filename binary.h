@@ -0,0 +1,100 @@
+#ifndef BINARY_H
+#define BINARY_H
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the classes.
+ */
+
+#include<string>
+#include<cstddef>
+
+/// <summary>
+/// Class representing an append-only binary buffer.
+/// Values are copied in their little-endian in-memory form, so writing is a
+/// plain memory copy into one growing buffer.
+/// Class Invariant: The buffer holds every value written, in order.
+/// </summary>
+class BinaryWriter
+{
+private:
+    // holds the encoded bytes
+    std::string buffer;
+
+public:
+    /// <summary>
+    /// Reserve function
+    /// Precondition: None.
+    /// Postcondition: Room for at least bytes bytes is allocated.
+    /// </summary>
+    void reserve(std::size_t bytes);
+
+    /// <summary>
+    /// Write functions
+    /// Precondition: None.
+    /// Postcondition: The value is appended to the buffer. Strings are
+    /// prefixed by their 32-bit length.
+    /// </summary>
+    void writeBytes(const void* data, std::size_t bytes);
+    void writeInt(int value);
+    void writeLong(long long value);
+    void writeUnsigned(unsigned long long value);
+    void writeDouble(double value);
+    void writeString(const std::string& value);
+
+    /// <summary>
+    /// Get Buffer function
+    /// Precondition: None.
+    /// Postcondition: The bytes written so far are returned.
+    /// </summary>
+    const std::string& getBuffer() const;
+
+    /// <summary>
+    /// Take Buffer function
+    /// Precondition: None.
+    /// Postcondition: The bytes written so far are moved out and the writer
+    /// is empty.
+    /// </summary>
+    std::string takeBuffer();
+};
+
+/// <summary>
+/// Class representing a reader over bytes produced by BinaryWriter.
+/// Class Invariant: The read position never passes the end of the data.
+/// </summary>
+class BinaryReader
+{
+private:
+    const char* data;       // bytes being read (not owned)
+    std::size_t size;       // number of bytes
+    std::size_t position;   // next byte to read
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: data must hold size bytes and outlive the reader.
+    /// Postcondition: A reader positioned at the first byte is created.
+    /// </summary>
+    BinaryReader(const char* data, std::size_t size);
+
+    /// <summary>
+    /// Read functions
+    /// Precondition: Enough bytes must remain for the value.
+    /// Postcondition: The next value is returned and the position advances
+    /// past it.
+    /// </summary>
+    void readBytes(void* out, std::size_t bytes);
+    int readInt();
+    long long readLong();
+    unsigned long long readUnsigned();
+    double readDouble();
+    std::string readString();
+
+    /// <summary>
+    /// Remaining function
+    /// Precondition: None.
+    /// Postcondition: The number of unread bytes is returned.
+    /// </summary>
+    std::size_t remaining() const;
+};
+
+#endif // !BINARY_H
@@ -0,0 +1,301 @@
+#include "campaign.h"
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <exception>
+#include <thread>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/*
+ * This is the implementation of campaign.h. CampaignSimulator follows how
+ * the expected yields of a plan change while its formulas gain proficiency
+ * over a long campaign.
+ *
+ * Implementation Invariant:
+ * Cycles are simulated step by step. The cycles since a mark form a block,
+ * and for every input the block keeps the lowest stock it was checked at
+ * and found enough, and the highest stock it was checked at and found
+ * short. If the next block makes every check the same way, it crafts the
+ * same steps and changes the stock by the same delta, so every input of
+ * the k-th next block sees what it saw in this one plus k * delta. A check
+ * is linear in k, so the extremes bound the number of blocks every input
+ * keeps its answer: one found enough until the lowest falls below need,
+ * one found short until the highest reaches it. That count, and the blocks
+ * until the next level-up, are skipped at once by adding delta, crafts and
+ * experience times the count. This gives exactly the stock a
+ * cycle-by-cycle run would.
+ * The mark moves to the current cycle whenever the block reaches its
+ * length, which then doubles (as in Brent's cycle detection), so a pattern
+ * of period P is found within about 3P cycles of settling, whatever P is.
+ * A skip of fewer cycles than the length is passed up: taking it would
+ * move the mark before a longer pattern could show, and simulating those
+ * cycles costs no more than waiting for the mark. A skip moves the mark
+ * and keeps the length; a level-up, after which the rates change, starts
+ * the length over at one cycle.
+ *
+ * Error Processing:
+ * run throws an std::invalid_argument exception for bad rules or a
+ * negative cycle count, and an std::overflow_error exception if skipping
+ * cycles overflows a stock. Errors of TierTable::at (a level whose weights
+ * are all zero) are passed on.
+ *
+ * Assumptions:
+ * Produce rates are those of FlowModel, at the level each formula has
+ * reached. The stock doesn't overflow within one simulated cycle.
+ */
+
+namespace
+{
+    // returns value + times * delta, checking for overflow
+    long long advance(long long value, long long times, long long delta)
+    {
+        long long step, total;
+        if (__builtin_mul_overflow(times, delta, &step) ||
+            __builtin_add_overflow(value, step, &total))
+            throw std::overflow_error("campaign stock overflow.");
+
+        return total;
+    }
+
+    // experience a formula at level needs for the next level
+    long long needed(const ExperienceRules& rules, int level)
+    {
+        return std::max(1LL, std::llround(rules.base *
+                                          std::pow(rules.growth, level)));
+    }
+}
+
+// Constructor
+CampaignSimulator::CampaignSimulator(const PlanView& plan)
+        : model(plan)
+{
+    for (int s = 0; s < plan.getSize(); ++s)
+    {
+        tiers.push_back(plan.getFormula(s).getTiers());
+        levels.push_back(plan.getFormula(s).getProficiency());
+    }
+}
+
+// Run function
+CampaignResult CampaignSimulator::run(const CampaignScenario& scenario) const
+{
+    const ExperienceRules& rules = scenario.rules;
+    if (scenario.cycles < 0 || rules.perCraft < 0 || !(rules.base > 0) ||
+        !(rules.growth > 0) || rules.maxLevel < 0)
+        throw std::invalid_argument("Campaign rules should be positive.");
+
+    const int steps = model.getSize();
+    const int items = model.getItemCount();
+
+    FlowModel::Stock stock = model.stock(scenario.start);
+    const FlowModel::Stock supply = model.stock(scenario.supply);
+
+    CampaignResult result;
+    result.curves.resize(steps);
+    result.transitions = 0;
+
+    std::vector<int> level(levels);
+    std::vector<Quantity> rate(steps);
+    std::vector<long long> experience(steps, 0), crafts(steps, 0);
+    for (int s = 0; s < steps; ++s)
+    {
+        rate[s] = tiers[s]->at(level[s])->expected;
+        result.curves[s].push_back(YieldPoint{ 0, level[s], rate[s], 0 });
+    }
+
+    // where the extremes of the inputs of each step start
+    std::vector<int> first(steps + 1, 0);
+    for (int s = 0; s < steps; ++s)
+        first[s + 1] = first[s] + static_cast<int>(model.getInputs(s).size());
+
+    long long cycle = 0;
+    std::vector<char> crafted(steps);
+    std::vector<long long> count(steps);
+    FlowModel::Stock delta(items);
+
+    // the block since the mark: where it starts, the length at which the
+    // mark moves on, the stock and crafts at the mark, and the extremes of
+    // every input found enough and found short
+    long long marked = 0, length = 1;
+    FlowModel::Stock mark;
+    std::vector<long long> before(steps);
+    std::vector<long long> lowest(first[steps]), highest(first[steps]);
+    auto restart = [&](long long next)
+    {
+        marked = cycle;
+        length = next;
+        mark = stock;
+        before = crafts;
+        std::fill(lowest.begin(), lowest.end(), LLONG_MAX);
+        std::fill(highest.begin(), highest.end(), LLONG_MIN);
+    };
+
+    restart(1);
+    while (cycle < scenario.cycles)
+    {
+        for (int i = 0; i < items; ++i)
+            stock[i] += supply[i];
+
+        for (int s = 0; s < steps; ++s)
+        {
+            const std::vector<FlowModel::Entry>& inputs = model.getInputs(s);
+            for (std::size_t k = 0; k < inputs.size(); ++k)
+            {
+                const long long have = stock[inputs[k].item];
+                if (have >= inputs[k].amount)
+                    lowest[first[s] + k] = std::min(lowest[first[s] + k],
+                                                    have);
+                else
+                    highest[first[s] + k] = std::max(highest[first[s] + k],
+                                                     have);
+            }
+
+            crafted[s] = model.run(s, stock, rate[s]);
+        }
+
+        // experience of this cycle
+        bool levelled = false;
+        for (int s = 0; s < steps; ++s)
+        {
+            if (!crafted[s])
+                continue;
+
+            crafts[s]++;
+            if (level[s] >= rules.maxLevel)
+                continue;
+
+            experience[s] += rules.perCraft;
+            while (level[s] < rules.maxLevel &&
+                   experience[s] >= needed(rules, level[s]))
+            {
+                experience[s] -= needed(rules, level[s]);
+                level[s]++;
+                levelled = true;
+            }
+
+            if (level[s] != result.curves[s].back().level)
+            {
+                rate[s] = tiers[s]->at(level[s])->expected;
+                result.transitions += level[s] - result.curves[s].back().level;
+                result.curves[s].push_back
+                        (YieldPoint{ cycle + 1, level[s], rate[s], crafts[s] });
+            }
+        }
+
+        ++cycle;
+        if (levelled)
+        {
+            restart(1);
+            continue;
+        }
+
+        // how many times the block can follow itself with every check
+        // giving the same answer
+        const long long period = cycle - marked;
+        long long repeat = (scenario.cycles - cycle) / period;
+        for (int i = 0; i < items; ++i)
+            delta[i] = stock[i] - mark[i];
+
+        for (int s = 0; s < steps && repeat > 0; ++s)
+        {
+            const std::vector<FlowModel::Entry>& inputs = model.getInputs(s);
+            for (std::size_t k = 0; k < inputs.size(); ++k)
+            {
+                const long long change = delta[inputs[k].item];
+                const long long low = lowest[first[s] + k];
+                const long long high = highest[first[s] + k];
+                const long long need = inputs[k].amount;
+
+                if (change < 0 && low != LLONG_MAX)
+                    repeat = std::min(repeat, (low - need) / -change);
+                else if (change > 0 && high != LLONG_MIN)
+                    repeat = std::min(repeat, (need - high - 1) / change);
+            }
+
+            // stop before the block that levels a formula up
+            count[s] = crafts[s] - before[s];
+            if (count[s] > 0 && level[s] < rules.maxLevel &&
+                rules.perCraft > 0)
+                repeat = std::min(repeat,
+                                  (needed(rules, level[s]) - experience[s] - 1) /
+                                  (count[s] * rules.perCraft));
+        }
+
+        // skip the blocks that repeat this one
+        if (repeat > 0 && repeat * period >= length)
+        {
+            for (int i = 0; i < items; ++i)
+                stock[i] = advance(stock[i], repeat, delta[i]);
+
+            for (int s = 0; s < steps; ++s)
+            {
+                crafts[s] += repeat * count[s];
+                if (level[s] < rules.maxLevel)
+                    experience[s] += repeat * count[s] * rules.perCraft;
+            }
+
+            cycle += repeat * period;
+            restart(length);
+        }
+        else if (period == length)
+            restart(2 * length);
+    }
+
+    for (int s = 0; s < steps; ++s)
+        result.curves[s].push_back
+                (YieldPoint{ scenario.cycles, level[s], rate[s], crafts[s] });
+    result.inventory = model.inventory(stock);
+
+    return result;
+}
+
+// Run all function
+std::vector<CampaignResult> CampaignSimulator::runAll
+        (const std::vector<CampaignScenario>& scenarios, int threads) const
+{
+    if (threads < 0)
+        throw std::invalid_argument("threads should be non-negative.");
+
+    std::vector<CampaignResult> results(scenarios.size());
+    std::size_t workers = threads > 0 ? threads :
+            std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, scenarios.size());
+
+    // scenarios differ in length, so threads take the next one when free
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr failure;
+    std::atomic<bool> failed(false);
+    auto work = [&]()
+    {
+        for (std::size_t i = next++; i < scenarios.size() && !failed;
+             i = next++)
+        {
+            try
+            {
+                results[i] = run(scenarios[i]);
+            }
+            catch (...)
+            {
+                if (!failed.exchange(true))
+                    failure = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t w = 1; w < workers; ++w)
+        pool.emplace_back(work);
+    work();
+    for (std::thread& thread : pool)
+        thread.join();
+
+    if (failure)
+        std::rethrow_exception(failure);
+
+    return results;
+}
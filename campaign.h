@@ -0,0 +1,112 @@
+#ifndef CAMPAIGN_H
+#define CAMPAIGN_H
+
+#include "flow.h"
+#include "plan.h"
+#include "quantity.h"
+#include "tiers.h"
+#include <memory>
+#include <vector>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/// <summary>
+/// How formulas gain proficiency. Every craft gives perCraft experience; a
+/// formula at level L needs round(base * growth^L) experience to reach level
+/// L + 1 (the experience is spent), and stops at maxLevel.
+/// </summary>
+struct ExperienceRules
+{
+    int perCraft = 1;
+    double base = 10;
+    double growth = 1.5;
+    int maxLevel = 5;
+};
+
+/// <summary>
+/// One production campaign: the plan is run cycles times, each cycle
+/// starting with supply added to the stock.
+/// </summary>
+struct CampaignScenario
+{
+    Inventory start;
+    Inventory supply;
+    long long cycles = 1;
+    ExperienceRules rules;
+};
+
+/// <summary>
+/// One point of a yield curve: from cycle on, the formula is at level and
+/// produces at rate; crafts is the number of crafts before that cycle.
+/// </summary>
+struct YieldPoint
+{
+    long long cycle;
+    int level;
+    Quantity rate;
+    long long crafts;
+};
+
+/// <summary>
+/// Result of a campaign. curves holds the yield curve of each step of the
+/// plan, one point at the start, one per level reached and one at the end.
+/// transitions is the number of level-ups.
+/// </summary>
+struct CampaignResult
+{
+    std::vector<std::vector<YieldPoint>> curves;
+    Inventory inventory;
+    long long transitions;
+};
+
+/// <summary>
+/// Class representing a proficiency progression simulator.
+/// A campaign runs the plan with expected produce rates (see FlowModel)
+/// while every craft earns its formula experience. The plan's formulas are
+/// not changed: each campaign starts from their current proficiency.
+/// Blocks of cycles that the following cycles would repeat exactly (same
+/// steps crafting, same stock change, no level-up) are skipped in one jump,
+/// so the result is exactly that of a cycle-by-cycle run. A campaign costs
+/// a few periods of its crafting pattern per level-up or change of pattern,
+/// whatever the number of cycles.
+/// Class Invariant: The model and tier tables match the plan the simulator
+/// was built from.
+/// </summary>
+class CampaignSimulator
+{
+private:
+    FlowModel model;
+    std::vector<std::shared_ptr<const TierTable>> tiers;
+    std::vector<int> levels;
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: None.
+    /// Postcondition: A simulator for the steps of plan is created.
+    /// </summary>
+    CampaignSimulator(const PlanView& plan);
+
+    /// <summary>
+    /// Run function
+    /// Precondition: cycles and perCraft must be non-negative, base and
+    /// growth positive, and maxLevel must be non-negative.
+    /// Postcondition: The result of the campaign is returned.
+    /// </summary>
+    CampaignResult run(const CampaignScenario& scenario) const;
+
+    /// <summary>
+    /// Run All function
+    /// Precondition: As for run. threads must be non-negative (0 for one per
+    /// core).
+    /// Postcondition: The results of the scenarios, in the same order, are
+    /// returned; the scenarios are run on several threads.
+    /// </summary>
+    std::vector<CampaignResult> runAll
+            (const std::vector<CampaignScenario>& scenarios,
+             int threads = 0) const;
+};
+
+#endif // !CAMPAIGN_H
@@ -0,0 +1,73 @@
+#include "catalog.h"
+#include "checkpoint.h"
+#include <stdexcept>
+#include <utility>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ *      - 2026, Oct 19 - Build the ratio solver of each snapshot on reload.
+ */
+
+/*
+ * This is the implementation of catalog.h. The Catalog class lets balancing
+ * changes be loaded into running simulations without restarting them or
+ * rebuilding their plans.
+ *
+ * Implementation Invariant:
+ * The published snapshot is a shared pointer read and written only through
+ * std::atomic_load and std::atomic_store, so acquiring it is one atomic
+ * reference-count increment and publishing it is one pointer swap. The new
+ * snapshot, including its RatioSolver, is fully built on the reloading
+ * thread before it is published, and the reload mutex is only held by
+ * writers while they pick the next version number, so a reload never pauses
+ * readers (or a server answering them) for longer than the swap itself.
+ *
+ * Error Processing:
+ * reloadFile throws an std::invalid_argument exception if the checkpoint
+ * holds no plan; errors reading the checkpoint are passed on from
+ * Checkpoint::restoreFile. The current snapshot is unchanged when a reload
+ * throws.
+ *
+ * Assumptions:
+ * Readers don't modify the formulas of a snapshot.
+ */
+
+// Constructor
+Catalog::Catalog(Plan formulas)
+{
+    RatioSolver solver(formulas);
+    current = std::make_shared<const CatalogSnapshot>(
+            CatalogSnapshot{1, std::move(formulas), std::move(solver)});
+}
+
+// Acquire function
+std::shared_ptr<const CatalogSnapshot> Catalog::acquire() const
+{
+    return std::atomic_load(&current);
+}
+
+// Reload function
+unsigned long long Catalog::reload(Plan formulas)
+{
+    // the solver is the slow part, so it is built before taking the lock
+    RatioSolver solver(formulas);
+
+    std::lock_guard<std::mutex> lock(reloading);
+
+    unsigned long long version = std::atomic_load(&current)->version + 1;
+    std::atomic_store(&current, std::make_shared<const CatalogSnapshot>(
+            CatalogSnapshot{version, std::move(formulas), std::move(solver)}));
+
+    return version;
+}
+
+// Reload file function
+unsigned long long Catalog::reloadFile(const std::string& path)
+{
+    // load outside the lock so a slow file never holds up other reloads
+    SimulationState state = Checkpoint::restoreFile(path);
+    if (state.plans.empty())
+        throw std::invalid_argument("checkpoint holds no catalog: " + path);
+
+    return reload(std::move(state.plans.front()));
+}
@@ -0,0 +1,84 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include "plan.h"
+#include "solver.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ *      - 2026, Oct 19 - Build the ratio solver of each snapshot on reload.
+ */
+
+/// <summary>
+/// One published version of a formula catalog. A snapshot never changes
+/// after it is published.
+/// </summary>
+struct CatalogSnapshot
+{
+    unsigned long long version;     // increases with every reload
+    Plan formulas;                  // the formulas of this version
+    RatioSolver solver;             // ratio solver over formulas
+};
+
+/// <summary>
+/// Class representing a formula catalog that can be reloaded while
+/// simulations are running.
+/// Readers acquire the current snapshot and keep it for as long as they
+/// need; a reload builds the next snapshot, with its RatioSolver, aside and
+/// publishes it with one atomic pointer swap. Trials in flight finish on the
+/// snapshot they hold, and the old snapshot is freed when its last reader
+/// lets go.
+/// Class Invariant: The current snapshot is never null, and versions only
+/// increase.
+/// </summary>
+class Catalog
+{
+private:
+    // holds the published snapshot, only accessed atomically
+    std::shared_ptr<const CatalogSnapshot> current;
+
+    // serializes reloads against each other (never taken by readers)
+    std::mutex reloading;
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: None.
+    /// Postcondition: A catalog publishing formulas as version 1 is created.
+    /// </summary>
+    explicit Catalog(Plan formulas = Plan());
+
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    /// <summary>
+    /// Acquire function
+    /// Precondition: None.
+    /// Postcondition: The current snapshot is returned; it stays valid for
+    /// as long as the caller holds it, whatever reloads happen meanwhile.
+    /// </summary>
+    std::shared_ptr<const CatalogSnapshot> acquire() const;
+
+    /// <summary>
+    /// Reload function
+    /// Precondition: None.
+    /// Postcondition: formulas is published as the next version, which is
+    /// returned. Snapshots acquired earlier are unaffected.
+    /// </summary>
+    unsigned long long reload(Plan formulas);
+
+    /// <summary>
+    /// Reload File function
+    /// Precondition: path must name a checkpoint file whose first plan is
+    /// the catalog.
+    /// Postcondition: The catalog is loaded from path and published as the
+    /// next version, which is returned. Readers are not blocked while the
+    /// file is loaded.
+    /// </summary>
+    unsigned long long reloadFile(const std::string& path);
+};
+
+#endif // !CATALOG_H
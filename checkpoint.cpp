@@ -0,0 +1,428 @@
+#include "checkpoint.h"
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ *      - 2026, Oct 19 - Save tier tables instead of the fixed four
+ *      probabilities (format version 2).
+ */
+
+/*
+ * This is the implementation of checkpoint.h. The Checkpoint class turns a
+ * SimulationState into one binary blob and back, so long simulations can be
+ * resumed after a job dies.
+ *
+ * Layout (every value in host byte order):
+ *   magic, version
+ *   material name table
+ *   tier tables: rate (raw), weight and gain of every tier
+ *   plans: formulas with inputs, outputs, proficiency and tier table index
+ *   inventories: material index and raw fixed-point quantity
+ *   streams: random number generator state words
+ *   checksum (FNV-1a over the 8-byte words of everything before it)
+ *
+ * Implementation Invariant:
+ * Every value is written in its exact binary form (raw Quantity values,
+ * tier weight doubles and generator words), so a restored state is
+ * bit-identical to the saved one. Each tier table is written once however
+ * many formulas share it, and the standard table isn't written at all;
+ * sampling data is rebuilt from the table and proficiency level. Material
+ * names are hashed once, in the pass that sizes the blob, which notes the
+ * index of every material in write order. The whole blob is built in one
+ * reserved buffer and written with a single call, and saveFile syncs the
+ * new file before renaming it and the directory after. Formulas are read
+ * straight into their maps, which the saved order fills from the end, and
+ * each level of a tier table is looked up once per restore.
+ *
+ * Error Processing:
+ * restore throws an std::runtime_error exception if the magic, version or
+ * checksum doesn't match or a material index is out of range, and
+ * BinaryReader throws an std::out_of_range exception if the blob is
+ * truncated. saveFile and restoreFile throw an std::runtime_error exception
+ * if the file can't be written or read.
+ *
+ * Assumptions:
+ * Checkpoints are restored on a host with the same byte order.
+ */
+
+namespace
+{
+    // "PLCK" in little-endian order
+    const int MAGIC = 0x4B434C50;
+
+    // format version
+    const int VERSION = 2;
+
+    // tier table index meaning TierTable::standard()
+    const int STANDARD = -1;
+
+    // FNV-1a hash of the bytes, taken a 64-bit word at a time
+    unsigned long long checksum(const char* data, std::size_t size)
+    {
+        const unsigned long long PRIME = 0x100000001B3ULL;
+        unsigned long long hash = 0xCBF29CE484222325ULL;
+
+        std::size_t i = 0;
+        for (; i + sizeof(hash) <= size; i += sizeof(hash))
+        {
+            unsigned long long word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash ^= word;
+            hash *= PRIME;
+        }
+        for (; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= PRIME;
+        }
+        return hash;
+    }
+
+    // reads an element count, which can't exceed the bytes left
+    int readCount(BinaryReader& reader)
+    {
+        int count = reader.readInt();
+        if (count < 0 || static_cast<std::size_t>(count) > reader.remaining())
+            throw std::runtime_error("checkpoint is corrupt. Bad count.");
+
+        return count;
+    }
+
+    // writes a material map as (name index, quantity) pairs, taking the
+    // name indices in order from ids
+    void writeMaterials(BinaryWriter& writer, const int*& ids,
+                        const std::map<std::string, int>& materials)
+    {
+        writer.writeInt(static_cast<int>(materials.size()));
+        for (const auto& material : materials)
+        {
+            writer.writeInt(*ids++);
+            writer.writeInt(material.second);
+        }
+    }
+
+    // writes all of data to the file descriptor
+    bool writeAll(int file, const char* data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t written = ::write(file, data, size);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+}
+
+// Name at function
+const std::string& Checkpoint::nameAt(const std::vector<std::string>& names,
+                                      int index)
+{
+    if (index < 0 || index >= static_cast<int>(names.size()))
+        throw std::runtime_error("checkpoint is corrupt. Bad material index.");
+
+    return names[index];
+}
+
+// Write formula function
+void Checkpoint::writeFormula(BinaryWriter& writer, const int*& ids,
+                              const TierIndex& tables, const Formula& formula)
+{
+    writeMaterials(writer, ids, formula.condition);
+    writeMaterials(writer, ids, formula.result);
+
+    writer.writeInt(formula.proficiency);
+    auto table = tables.find(formula.tiers.get());
+    writer.writeInt(table == tables.end() ? STANDARD : table->second);
+}
+
+// Read formula function
+Formula* Checkpoint::readFormula(BinaryReader& reader,
+                                 const std::vector<std::string>& names,
+                                 const TierList& tables, LevelCache& levels)
+{
+    Formula* formula = new Formula();
+
+    try
+    {
+        std::map<std::string, int>* sides[] = {&formula->condition,
+                                               &formula->result};
+        for (std::map<std::string, int>* side : sides)
+        {
+            int count = readCount(reader);
+            for (int i = 0; i < count; ++i)
+            {
+                const std::string& name = nameAt(names, reader.readInt());
+                int quantity = reader.readInt();
+                if (name.empty() || quantity <= 0)
+                    throw std::runtime_error
+                            ("checkpoint is corrupt. Bad formula.");
+
+                side->emplace_hint(side->end(), name, quantity);
+            }
+            if (count == 0 || static_cast<int>(side->size()) != count)
+                throw std::runtime_error("checkpoint is corrupt. Bad formula.");
+        }
+
+        int proficiency = reader.readInt();
+        int table = reader.readInt();
+        if (proficiency < 0 || table < STANDARD ||
+            table >= static_cast<int>(tables.size()))
+            throw std::runtime_error("checkpoint is corrupt. Bad formula.");
+
+        formula->tiers = table == STANDARD ? TierTable::standard()
+                                           : tables[table];
+        formula->proficiency = proficiency;
+
+        std::vector<std::shared_ptr<const TierTable::Level>>& known =
+                levels[table - STANDARD];
+        if (known.size() <= static_cast<std::size_t>(proficiency))
+            known.resize(proficiency + 1);
+        if (!known[proficiency])
+            known[proficiency] = formula->tiers->at(proficiency);
+        formula->level = known[proficiency];
+    }
+    catch (...)
+    {
+        delete formula;
+        throw;
+    }
+
+    return formula;
+}
+
+// Save function
+std::string Checkpoint::save(const SimulationState& state)
+{
+    // collect every material name and tier table once
+    NameTable names;
+    TierIndex tables;
+    std::vector<const TierTable*> tableOrder;
+    std::vector<const std::string*> order;
+    std::vector<int> ids;
+    std::size_t estimate = sizeof(int) * 4;
+
+    // notes the index of name, in the order the materials are written
+    auto add = [&](const std::string& name)
+    {
+        auto found = names.try_emplace(name, static_cast<int>(order.size()));
+        if (found.second)
+        {
+            order.push_back(&name);
+            estimate += sizeof(int) + name.size();
+        }
+        ids.push_back(found.first->second);
+    };
+
+    for (const Plan& plan : state.plans)
+    {
+        for (int i = 0; i < plan.size; ++i)
+        {
+            const Formula& formula = *plan.sequences[i];
+            for (const auto& material : formula.condition)
+                add(material.first);
+            for (const auto& material : formula.result)
+                add(material.first);
+
+            estimate += sizeof(int) * 2 * (formula.condition.size() +
+                    formula.result.size() + 2);
+
+            const TierTable* table = formula.tiers.get();
+            if (table != TierTable::standard().get() &&
+                tables.emplace(table, static_cast<int>(tableOrder.size())).second)
+            {
+                tableOrder.push_back(table);
+                estimate += sizeof(int) + table->getSize() * sizeof(Tier);
+            }
+        }
+    }
+    for (const Inventory& inventory : state.inventories)
+    {
+        for (const auto& material : inventory)
+            add(material.first);
+
+        estimate += (sizeof(int) + sizeof(long long)) * (inventory.size() + 1);
+    }
+    estimate += sizeof(Random) * state.streams.size() + sizeof(long long);
+
+    BinaryWriter writer;
+    writer.reserve(estimate);
+
+    writer.writeInt(MAGIC);
+    writer.writeInt(VERSION);
+
+    writer.writeInt(static_cast<int>(order.size()));
+    for (const std::string* name : order)
+        writer.writeString(*name);
+
+    writer.writeInt(static_cast<int>(tableOrder.size()));
+    for (const TierTable* table : tableOrder)
+    {
+        writer.writeInt(table->getSize());
+        for (int i = 0; i < table->getSize(); ++i)
+        {
+            const Tier& tier = table->getTier(i);
+            writer.writeLong(tier.rate.getRaw());
+            writer.writeDouble(tier.weight);
+            writer.writeDouble(tier.gain);
+        }
+    }
+
+    const int* next = ids.data();
+
+    writer.writeInt(static_cast<int>(state.plans.size()));
+    for (const Plan& plan : state.plans)
+    {
+        writer.writeInt(plan.size);
+        for (int i = 0; i < plan.size; ++i)
+            writeFormula(writer, next, tables, *plan.sequences[i]);
+    }
+
+    writer.writeInt(static_cast<int>(state.inventories.size()));
+    for (const Inventory& inventory : state.inventories)
+    {
+        writer.writeInt(static_cast<int>(inventory.size()));
+        for (const auto& material : inventory)
+        {
+            writer.writeInt(*next++);
+            writer.writeLong(material.second.getRaw());
+        }
+    }
+
+    writer.writeInt(static_cast<int>(state.streams.size()));
+    for (const Random& stream : state.streams)
+        writer.writeBytes(stream.state, sizeof(stream.state));
+
+    const std::string& bytes = writer.getBuffer();
+    writer.writeUnsigned(checksum(bytes.data(), bytes.size()));
+
+    return writer.takeBuffer();
+}
+
+// Restore function
+SimulationState Checkpoint::restore(const std::string& blob)
+{
+    const std::size_t body = blob.size() < sizeof(long long)
+            ? 0 : blob.size() - sizeof(long long);
+
+    BinaryReader trailer(blob.data() + body, blob.size() - body);
+    if (trailer.readUnsigned() != checksum(blob.data(), body))
+        throw std::runtime_error("checkpoint is corrupt. Bad checksum.");
+
+    BinaryReader reader(blob.data(), body);
+    if (reader.readInt() != MAGIC)
+        throw std::runtime_error("checkpoint is corrupt. Bad magic.");
+    if (reader.readInt() != VERSION)
+        throw std::runtime_error("checkpoint version isn't supported.");
+
+    std::vector<std::string> names(readCount(reader));
+    for (std::string& name : names)
+        name = reader.readString();
+
+    TierList tables(readCount(reader));
+    for (std::shared_ptr<const TierTable>& table : tables)
+    {
+        std::vector<Tier> tiers(readCount(reader));
+        for (Tier& tier : tiers)
+        {
+            tier.rate = Quantity::fromRaw(reader.readLong());
+            tier.weight = reader.readDouble();
+            tier.gain = reader.readDouble();
+        }
+        table = std::make_shared<const TierTable>(
+                tiers.data(), static_cast<int>(tiers.size()));
+    }
+
+    SimulationState state;
+    LevelCache levels(tables.size() - STANDARD);
+
+    state.plans.resize(readCount(reader));
+    for (Plan& plan : state.plans)
+    {
+        int size = readCount(reader);
+
+        plan.sequences = new Formula*[size];
+        plan.capacity = size;
+        for (int i = 0; i < size; ++i)
+        {
+            plan.sequences[i] = readFormula(reader, names, tables, levels);
+            plan.size = i + 1;
+        }
+    }
+
+    state.inventories.resize(readCount(reader));
+    for (Inventory& inventory : state.inventories)
+    {
+        int count = readCount(reader);
+        for (int i = 0; i < count; ++i)
+        {
+            const std::string& name = nameAt(names, reader.readInt());
+            inventory[name] = Quantity::fromRaw(reader.readLong());
+        }
+    }
+
+    state.streams.resize(readCount(reader));
+    for (Random& stream : state.streams)
+        reader.readBytes(stream.state, sizeof(stream.state));
+
+    return state;
+}
+
+// Save file function
+void Checkpoint::saveFile(const std::string& path,
+                          const SimulationState& state)
+{
+    const std::string blob = save(state);
+    const std::string temporary = path + ".tmp";
+
+    // the new checkpoint must be on disk before it replaces the old one
+    const int file = ::open(temporary.c_str(),
+                            O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file < 0)
+        throw std::runtime_error("checkpoint save failed: " + temporary);
+
+    const bool written = writeAll(file, blob.data(), blob.size()) &&
+                         ::fsync(file) == 0;
+    if (::close(file) != 0 || !written)
+        throw std::runtime_error("checkpoint save failed: " + temporary);
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("checkpoint save failed: " + path);
+
+    // and the rename must be on disk before the save counts as done
+    const std::size_t slash = path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "."
+            : slash == 0 ? "/" : path.substr(0, slash);
+    const int folder = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (folder < 0)
+        throw std::runtime_error("checkpoint save failed: " + directory);
+
+    const bool synced = ::fsync(folder) == 0;
+    if (::close(folder) != 0 || !synced)
+        throw std::runtime_error("checkpoint save failed: " + directory);
+}
+
+// Restore file function
+SimulationState Checkpoint::restoreFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("checkpoint restore failed: " + path);
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+
+    return restore(contents.str());
+}
@@ -0,0 +1,101 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "plan.h"
+#include "random.h"
+#include "quantity.h"
+#include "binary.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ *      - 2026, Oct 19 - Save tier tables instead of the fixed four
+ *      probabilities (format version 2).
+ */
+
+/// <summary>
+/// Complete state of a running simulation: the plans with the proficiency
+/// and tier table of every formula, the inventories and the random
+/// number streams.
+/// </summary>
+struct SimulationState
+{
+    std::vector<Plan> plans;
+    std::vector<Inventory> inventories;
+    std::vector<Random> streams;
+};
+
+/// <summary>
+/// Class representing the binary checkpoint format of a SimulationState.
+/// A checkpoint is one compact blob: tables of material names and tier
+/// tables followed by the plans, inventories and streams that refer to them
+/// by index, and a checksum. Restoring a checkpoint continues the simulation
+/// bit for bit.
+/// Class Invariant: None (the class only has static functions).
+/// </summary>
+class Checkpoint
+{
+private:
+    // holds material names by index while writing
+    typedef std::unordered_map<std::string, int> NameTable;
+
+    // holds tier tables by index while writing
+    typedef std::map<const TierTable*, int> TierIndex;
+
+    // holds tier tables by index while reading
+    typedef std::vector<std::shared_ptr<const TierTable>> TierList;
+
+    // holds the levels looked up so far while reading, by tier table index
+    // (the standard table first) and proficiency
+    typedef std::vector<std::vector<std::shared_ptr<const TierTable::Level>>>
+            LevelCache;
+
+    // writes or reads one formula; writing takes the material indices in
+    // order from ids
+    static void writeFormula(BinaryWriter& writer, const int*& ids,
+                             const TierIndex& tables, const Formula& formula);
+    static Formula* readFormula(BinaryReader& reader,
+                                const std::vector<std::string>& names,
+                                const TierList& tables, LevelCache& levels);
+
+    // returns the name at index, checking the index
+    static const std::string& nameAt(const std::vector<std::string>& names,
+                                     int index);
+
+public:
+    /// <summary>
+    /// Save function
+    /// Precondition: None.
+    /// Postcondition: The binary checkpoint of state is returned.
+    /// </summary>
+    static std::string save(const SimulationState& state);
+
+    /// <summary>
+    /// Restore function
+    /// Precondition: blob must be a checkpoint returned by save.
+    /// Postcondition: The saved SimulationState is returned.
+    /// </summary>
+    static SimulationState restore(const std::string& blob);
+
+    /// <summary>
+    /// Save File function
+    /// Precondition: The directory of path must be writable.
+    /// Postcondition: The checkpoint of state replaces the file at path
+    /// atomically and is synced to disk, with the directory entry, before
+    /// the function returns; a crash or power loss while saving leaves the
+    /// previous file intact.
+    /// </summary>
+    static void saveFile(const std::string& path, const SimulationState& state);
+
+    /// <summary>
+    /// Restore File function
+    /// Precondition: path must name a file written by saveFile.
+    /// Postcondition: The saved SimulationState is returned.
+    /// </summary>
+    static SimulationState restoreFile(const std::string& path);
+};
+
+#endif // !CHECKPOINT_H
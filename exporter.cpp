@@ -0,0 +1,332 @@
+#include "exporter.h"
+#include <stdexcept>
+#include <algorithm>
+#include <system_error>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/*
+ * This is the implementation of exporter.h. The PlanExporter class streams
+ * plans and inventories as text, CSV or JSON without building the output in
+ * memory first.
+ *
+ * Implementation Invariant:
+ * All output goes through put(), which copies into the fixed buffer and
+ * hands the buffer to the destination whenever it is full. The buffer is
+ * allocated once, at STREAM_CHUNK characters when the stream's own buffer
+ * does the batching and at DESCRIPTOR_CHUNK when every flush is a write
+ * system call. Numbers and
+ * quantities are formatted into small stack arrays, so no step of an export
+ * allocates memory.
+ *
+ * Error Processing:
+ * flush throws an std::runtime_error exception if the stream fails, and an
+ * std::system_error exception if writing to the file descriptor fails.
+ *
+ * Assumptions:
+ * Material names are UTF-8 (JSON output escapes only quotes, backslashes
+ * and control characters).
+ */
+
+namespace
+{
+    // longest text of a long long
+    const int NUMBER_CHARS = 24;
+}
+
+// Stream constructor
+PlanExporter::PlanExporter(std::ostream& os, Format format)
+        : stream(&os), descriptor(-1), format(format), buffer(STREAM_CHUNK),
+          used(0)
+{
+}
+
+// File descriptor constructor
+PlanExporter::PlanExporter(int descriptor, Format format)
+        : stream(nullptr), descriptor(descriptor), format(format),
+          buffer(DESCRIPTOR_CHUNK), used(0)
+{
+}
+
+// Destructor
+PlanExporter::~PlanExporter()
+{
+    try
+    {
+        flush();
+    }
+    catch (std::exception&)
+    {
+        // destructors must not throw; flush() reports errors to callers
+    }
+}
+
+// Put functions
+void PlanExporter::put(const char* text, std::size_t length)
+{
+    while (length > 0)
+    {
+        if (used == buffer.size())
+            flush();
+
+        std::size_t count = std::min(length, buffer.size() - used);
+        std::memcpy(buffer.data() + used, text, count);
+        used += count;
+        text += count;
+        length -= count;
+    }
+}
+
+void PlanExporter::put(const std::string& text)
+{
+    put(text.data(), text.size());
+}
+
+void PlanExporter::put(char c)
+{
+    if (used == buffer.size())
+        flush();
+
+    buffer[used++] = c;
+}
+
+void PlanExporter::putNumber(long long number)
+{
+    char text[NUMBER_CHARS];
+    int length = 0;
+
+    unsigned long long magnitude = number < 0
+            ? 0ULL - static_cast<unsigned long long>(number)
+            : static_cast<unsigned long long>(number);
+    do
+    {
+        text[NUMBER_CHARS - ++length] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (number < 0)
+        text[NUMBER_CHARS - ++length] = '-';
+
+    put(text + NUMBER_CHARS - length, length);
+}
+
+void PlanExporter::putQuantity(const Quantity& quantity)
+{
+    char text[Quantity::MAX_CHARS];
+    put(text, quantity.toChars(text));
+}
+
+// Put name function
+void PlanExporter::putName(const std::string& name)
+{
+    if (format == CSV)
+    {
+        if (name.find_first_of(",\"\r\n") == std::string::npos)
+        {
+            put(name);
+            return;
+        }
+
+        put('"');
+        for (char c : name)
+        {
+            if (c == '"')
+                put('"');
+            put(c);
+        }
+        put('"');
+    }
+    else if (format == JSON)
+    {
+        const char* HEX = "0123456789abcdef";
+
+        put('"');
+        for (char c : name)
+        {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\')
+            {
+                put('\\');
+                put(c);
+            }
+            else if (u < 0x20)
+            {
+                put("\\u00", 4);
+                put(HEX[u >> 4]);
+                put(HEX[u & 0xF]);
+            }
+            else
+            {
+                put(c);
+            }
+        }
+        put('"');
+    }
+    else
+    {
+        put(name);
+    }
+}
+
+// Put materials function
+void PlanExporter::putMaterials(const std::map<std::string, int>& materials,
+                                int step, const char* role)
+{
+    for (auto it = materials.begin(); it != materials.end(); ++it)
+    {
+        switch (format)
+        {
+            case TEXT:
+                if (it != materials.begin())
+                    put(", ", 2);
+                putNumber(it->second);
+                put(' ');
+                putName(it->first);
+                break;
+
+            case CSV:
+                putNumber(step);
+                put(',');
+                put(role, std::strlen(role));
+                put(',');
+                putName(it->first);
+                put(',');
+                putNumber(it->second);
+                put('\n');
+                break;
+
+            case JSON:
+                if (it != materials.begin())
+                    put(',');
+                putName(it->first);
+                put(':');
+                putNumber(it->second);
+                break;
+        }
+    }
+}
+
+// Write plan function
+void PlanExporter::writePlan(const PlanView& plan)
+{
+    const int INDEX = 1;
+
+    if (format == CSV)
+        put("step,role,material,quantity\n");
+    else if (format == JSON)
+        put("{\"steps\":[");
+
+    for (int i = 0; i < plan.getSize(); ++i)
+    {
+        const Formula& formula = plan.getFormula(i);
+
+        switch (format)
+        {
+            case TEXT:
+                put('(');
+                putNumber(i + INDEX);
+                put(") ", 2);
+                putMaterials(formula.getCondition(), i + INDEX, "input");
+                put("-> ", 3);
+                putMaterials(formula.getResult(), i + INDEX, "output");
+                put('\n');
+                break;
+
+            case CSV:
+                putMaterials(formula.getCondition(), i + INDEX, "input");
+                putMaterials(formula.getResult(), i + INDEX, "output");
+                break;
+
+            case JSON:
+                if (i > 0)
+                    put(',');
+                put("{\"step\":");
+                putNumber(i + INDEX);
+                put(",\"inputs\":{");
+                putMaterials(formula.getCondition(), i + INDEX, "input");
+                put("},\"outputs\":{");
+                putMaterials(formula.getResult(), i + INDEX, "output");
+                put("}}");
+                break;
+        }
+    }
+
+    if (format == JSON)
+        put("]}\n");
+}
+
+// Write inventory function
+void PlanExporter::writeInventory(const Inventory& inventory)
+{
+    if (format == CSV)
+        put("material,quantity\n");
+    else if (format == JSON)
+        put('{');
+
+    for (auto it = inventory.begin(); it != inventory.end(); ++it)
+    {
+        switch (format)
+        {
+            case TEXT:
+                putQuantity(it->second);
+                put(' ');
+                putName(it->first);
+                put('\n');
+                break;
+
+            case CSV:
+                putName(it->first);
+                put(',');
+                putQuantity(it->second);
+                put('\n');
+                break;
+
+            case JSON:
+                if (it != inventory.begin())
+                    put(',');
+                putName(it->first);
+                put(':');
+                putQuantity(it->second);
+                break;
+        }
+    }
+
+    if (format == JSON)
+        put("}\n");
+}
+
+// Flush function
+void PlanExporter::flush()
+{
+    if (used == 0)
+        return;
+
+    if (stream != nullptr)
+    {
+        stream->write(buffer.data(), static_cast<std::streamsize>(used));
+        if (!*stream)
+            throw std::runtime_error("export failed. Stream error.");
+    }
+    else
+    {
+        std::size_t written = 0;
+        while (written < used)
+        {
+            ssize_t n = ::write(descriptor, buffer.data() + written,
+                                used - written);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                throw std::system_error(errno, std::generic_category(),
+                                        "export failed");
+            written += n;
+        }
+    }
+
+    used = 0;
+}
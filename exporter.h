@@ -0,0 +1,113 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include "plan.h"
+#include "quantity.h"
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/// <summary>
+/// Class representing a streaming writer of plans and simulation results.
+/// Text goes through one fixed-size buffer that is handed to the output
+/// stream or file descriptor whenever it fills, so exporting a plan of any
+/// length uses constant extra memory and never builds the whole text. A
+/// stream buffers on its own, so a stream exporter only keeps a small
+/// buffer; a file descriptor exporter keeps a large one to save system
+/// calls.
+/// Formats:
+///   TEXT  the Plan::toString() format, "(1) 2 iron ore-> 1 iron bar"
+///   CSV   one row per material: step,role,material,quantity
+///   JSON  {"steps":[{"step":1,"inputs":{...},"outputs":{...}}]}
+/// Class Invariant: The buffer never holds more than STREAM_CHUNK
+/// characters for a stream or DESCRIPTOR_CHUNK for a file descriptor, and
+/// everything written is delivered by flush() or destruction.
+/// </summary>
+class PlanExporter
+{
+public:
+    // output formats
+    enum Format { TEXT, CSV, JSON };
+
+private:
+    // size of the output buffer for each destination
+    static const int STREAM_CHUNK = 512;
+    static const int DESCRIPTOR_CHUNK = 64 * 1024;
+
+    std::ostream* stream;       // destination stream, or null
+    int descriptor;             // destination file descriptor, or -1
+    Format format;              // output format
+    std::vector<char> buffer;   // pending output
+    std::size_t used;           // characters pending in buffer
+
+    // appends text to the buffer, flushing it when full
+    void put(const char* text, std::size_t length);
+    void put(const std::string& text);
+    void put(char c);
+    void putNumber(long long number);
+    void putQuantity(const Quantity& quantity);
+
+    // appends a material name quoted for the format
+    void putName(const std::string& name);
+
+    // appends one side of a formula in the format
+    void putMaterials(const std::map<std::string, int>& materials,
+                      int step, const char* role);
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: os must outlive the exporter.
+    /// Postcondition: An exporter writing format to os is created.
+    /// </summary>
+    PlanExporter(std::ostream& os, Format format = TEXT);
+
+    /// <summary>
+    /// Constructor
+    /// Precondition: descriptor must be open for writing while the exporter
+    /// exists; it isn't closed by the exporter.
+    /// Postcondition: An exporter writing format to descriptor is created.
+    /// </summary>
+    PlanExporter(int descriptor, Format format = TEXT);
+
+    PlanExporter(const PlanExporter&) = delete;
+    PlanExporter& operator=(const PlanExporter&) = delete;
+
+    /// <summary>
+    /// Destructor
+    /// Precondition: None.
+    /// Postcondition: Pending output is flushed; errors are ignored here, so
+    /// call flush() first to see them.
+    /// </summary>
+    ~PlanExporter();
+
+    /// <summary>
+    /// Write Plan function
+    /// Precondition: None.
+    /// Postcondition: Every step of plan is written in the format.
+    /// </summary>
+    void writePlan(const PlanView& plan);
+
+    /// <summary>
+    /// Write Inventory function
+    /// Precondition: None.
+    /// Postcondition: The material totals of a simulation are written in the
+    /// format ("quantity material" lines for TEXT, material,quantity rows for
+    /// CSV, an object for JSON).
+    /// </summary>
+    void writeInventory(const Inventory& inventory);
+
+    /// <summary>
+    /// Flush function
+    /// Precondition: None.
+    /// Postcondition: Pending output is delivered to the destination.
+    /// </summary>
+    void flush();
+};
+
+#endif // !EXPORTER_H
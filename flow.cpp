@@ -0,0 +1,220 @@
+#include "flow.h"
+#include <stdexcept>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ *      - 2026, Oct 19 - Add getResults() for other produce rates.
+ */
+
+/*
+ * This is the implementation of flow.h. FlowModel gives the planning tools
+ * (step ordering and upgrade analysis) a fast, deterministic stand-in for
+ * Plan::simulate that works on integer vectors instead of name maps.
+ *
+ * Implementation Invariant:
+ * inputs, results, outputs and rates have one entry per step. outputs[s]
+ * holds rates[s] * results[s] rounded like Formula::collect, so running a
+ * step at its own rate is only integer additions. A Stock is indexed by
+ * material id.
+ *
+ * Error Processing:
+ * getName, getInputs, getOutputs, getResults and getRate throw an
+ * std::out_of_range exception for a bad index. The run and simulate
+ * functions don't check their arguments; they sit on the hot path of the
+ * searches.
+ *
+ * Assumptions:
+ * The formulas of the plan aren't changed while the model is in use.
+ */
+
+const int FlowModel::NONE;
+
+// Constructor
+FlowModel::FlowModel(const PlanView& plan)
+{
+    const int steps = plan.getSize();
+    inputs.resize(steps);
+    results.resize(steps);
+    outputs.resize(steps);
+    rates.reserve(steps);
+
+    for (int s = 0; s < steps; ++s)
+    {
+        const Formula& formula = plan.getFormula(s);
+        const Quantity rate = formula.expectedRate();
+        rates.push_back(rate);
+
+        for (const auto& input : formula.getCondition())
+            inputs[s].push_back(Entry{ intern(input.first),
+                                       Quantity(input.second).getRaw() });
+
+        for (const auto& output : formula.getResult())
+        {
+            const int item = intern(output.first);
+            results[s].push_back(Entry{ item,
+                                        Quantity(output.second).getRaw() });
+            outputs[s].push_back(Entry{ item,
+                                        (rate * output.second).getRaw() });
+        }
+    }
+}
+
+// Intern function
+int FlowModel::intern(const std::string& name)
+{
+    auto found = ids.find(name);
+    if (found != ids.end())
+        return found->second;
+
+    const int id = static_cast<int>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+
+    return id;
+}
+
+// Get size function
+int FlowModel::getSize() const
+{
+    return static_cast<int>(rates.size());
+}
+
+// Get item count function
+int FlowModel::getItemCount() const
+{
+    return static_cast<int>(names.size());
+}
+
+// Get name function
+const std::string& FlowModel::getName(int item) const
+{
+    if (item < 0 || item >= getItemCount())
+        throw std::out_of_range("Get failed. Material out of range.");
+
+    return names[item];
+}
+
+// Find function
+int FlowModel::find(const std::string& name) const
+{
+    auto found = ids.find(name);
+
+    return found == ids.end() ? NONE : found->second;
+}
+
+// Get inputs function
+const std::vector<FlowModel::Entry>& FlowModel::getInputs(int step) const
+{
+    if (step < 0 || step >= getSize())
+        throw std::out_of_range("Get failed. Step out of range.");
+
+    return inputs[step];
+}
+
+// Get outputs function
+const std::vector<FlowModel::Entry>& FlowModel::getOutputs(int step) const
+{
+    if (step < 0 || step >= getSize())
+        throw std::out_of_range("Get failed. Step out of range.");
+
+    return outputs[step];
+}
+
+// Get results function
+const std::vector<FlowModel::Entry>& FlowModel::getResults(int step) const
+{
+    if (step < 0 || step >= getSize())
+        throw std::out_of_range("Get failed. Step out of range.");
+
+    return results[step];
+}
+
+// Get rate function
+const Quantity& FlowModel::getRate(int step) const
+{
+    if (step < 0 || step >= getSize())
+        throw std::out_of_range("Get failed. Step out of range.");
+
+    return rates[step];
+}
+
+// Stock function
+FlowModel::Stock FlowModel::stock(const Inventory& inventory) const
+{
+    Stock result(names.size(), 0);
+
+    for (const auto& held : inventory)
+    {
+        const int item = find(held.first);
+        if (item != NONE)
+            result[item] = held.second.getRaw();
+    }
+
+    return result;
+}
+
+// Inventory function
+Inventory FlowModel::inventory(const Stock& stock) const
+{
+    Inventory result;
+
+    for (int i = 0; i < getItemCount(); ++i)
+        result[names[i]] = Quantity::fromRaw(stock[i]);
+
+    return result;
+}
+
+// Can run function
+bool FlowModel::canRun(int step, const Stock& stock) const
+{
+    for (const Entry& input : inputs[step])
+    {
+        if (stock[input.item] < input.amount)
+            return false;
+    }
+
+    return true;
+}
+
+// Run function
+bool FlowModel::run(int step, Stock& stock) const
+{
+    if (!canRun(step, stock))
+        return false;
+
+    for (const Entry& input : inputs[step])
+        stock[input.item] -= input.amount;
+    for (const Entry& output : outputs[step])
+        stock[output.item] += output.amount;
+
+    return true;
+}
+
+// Run at rate function
+bool FlowModel::run(int step, Stock& stock, const Quantity& rate) const
+{
+    if (!canRun(step, stock))
+        return false;
+
+    for (const Entry& input : inputs[step])
+        stock[input.item] -= input.amount;
+    for (const Entry& result : results[step])
+        stock[result.item] +=
+                (rate * Quantity::fromRaw(result.amount)).getRaw();
+
+    return true;
+}
+
+// Simulate function
+int FlowModel::simulate(const std::vector<int>& order, Stock& stock) const
+{
+    int crafted = 0;
+
+    for (int step : order)
+    {
+        if (run(step, stock))
+            ++crafted;
+    }
+
+    return crafted;
+}
@@ -0,0 +1,167 @@
+#ifndef FLOW_H
+#define FLOW_H
+
+#include "plan.h"
+#include "quantity.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ *      - 2026, Oct 19 - Add getResults() for other produce rates.
+ */
+
+/// <summary>
+/// Class representing the deterministic material flow of a Plan.
+/// Every material gets an integer id and every step becomes a sparse list of
+/// inputs and outputs in raw Quantity units, with outputs taken at the
+/// expected produce rate of the step's current proficiency. Running a step
+/// works like Formula::craft: it crafts once if every input is in stock and
+/// does nothing otherwise, but always yields the expected amount instead of
+/// a random one, so the same order on the same stock always gives the same
+/// result.
+/// Class Invariant: The steps match the plan the model was built from, and
+/// every material named by a step has an id below getItemCount().
+/// </summary>
+class FlowModel
+{
+public:
+    /// <summary>
+    /// Stock of every material by id, in raw Quantity units.
+    /// </summary>
+    typedef std::vector<long long> Stock;
+
+    /// <summary>
+    /// One material amount of a step.
+    /// </summary>
+    struct Entry
+    {
+        int item;           // material id
+        long long amount;   // raw Quantity units
+    };
+
+    // value marking a missing material
+    static const int NONE = -1;
+
+private:
+    // holds material names by id, and ids by name
+    std::vector<std::string> names;
+    std::map<std::string, int> ids;
+
+    // holds the inputs, base outputs (rate 1) and expected outputs by step
+    std::vector<std::vector<Entry>> inputs;
+    std::vector<std::vector<Entry>> results;
+    std::vector<std::vector<Entry>> outputs;
+
+    // holds the expected produce rate of each step
+    std::vector<Quantity> rates;
+
+    // interns a material name
+    int intern(const std::string& name);
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: None.
+    /// Postcondition: The flow of every step of plan is built at the current
+    /// proficiency of its Formula.
+    /// </summary>
+    FlowModel(const PlanView& plan);
+
+    /// <summary>
+    /// Get Size function
+    /// Precondition: None.
+    /// Postcondition: The number of steps is returned.
+    /// </summary>
+    int getSize() const;
+
+    /// <summary>
+    /// Get Item Count function
+    /// Precondition: None.
+    /// Postcondition: The number of materials is returned.
+    /// </summary>
+    int getItemCount() const;
+
+    /// <summary>
+    /// Get Name function
+    /// Precondition: item must be a valid material id.
+    /// Postcondition: The name of the material is returned.
+    /// </summary>
+    const std::string& getName(int item) const;
+
+    /// <summary>
+    /// Find function
+    /// Precondition: None.
+    /// Postcondition: The id of the material is returned, NONE if no step
+    /// uses it.
+    /// </summary>
+    int find(const std::string& name) const;
+
+    /// <summary>
+    /// Get Inputs / Get Outputs function
+    /// Precondition: step must be a valid step index.
+    /// Postcondition: The inputs, or the outputs at the expected rate, of
+    /// the step are returned.
+    /// </summary>
+    const std::vector<Entry>& getInputs(int step) const;
+    const std::vector<Entry>& getOutputs(int step) const;
+
+    /// <summary>
+    /// Get Results function
+    /// Precondition: step must be a valid step index.
+    /// Postcondition: The outputs of the step at a produce rate of 1 are
+    /// returned; rate * amount (as Quantity) gives the output at rate.
+    /// </summary>
+    const std::vector<Entry>& getResults(int step) const;
+
+    /// <summary>
+    /// Get Rate function
+    /// Precondition: step must be a valid step index.
+    /// Postcondition: The expected produce rate of the step is returned.
+    /// </summary>
+    const Quantity& getRate(int step) const;
+
+    /// <summary>
+    /// Stock function
+    /// Precondition: None.
+    /// Postcondition: The stock of inventory is returned; materials no step
+    /// uses are left out.
+    /// </summary>
+    Stock stock(const Inventory& inventory) const;
+
+    /// <summary>
+    /// Inventory function
+    /// Precondition: stock must have getItemCount() entries.
+    /// Postcondition: The inventory holding stock is returned.
+    /// </summary>
+    Inventory inventory(const Stock& stock) const;
+
+    /// <summary>
+    /// Can Run function
+    /// Precondition: step must be a valid step index, and stock must have
+    /// getItemCount() entries.
+    /// Postcondition: true is returned if every input of step is in stock.
+    /// </summary>
+    bool canRun(int step, const Stock& stock) const;
+
+    /// <summary>
+    /// Run function
+    /// Precondition: As for canRun.
+    /// Postcondition: If step can run, its inputs are taken from stock, its
+    /// outputs at the expected rate (or at rate) are added and true is
+    /// returned; otherwise stock is unchanged and false is returned.
+    /// </summary>
+    bool run(int step, Stock& stock) const;
+    bool run(int step, Stock& stock, const Quantity& rate) const;
+
+    /// <summary>
+    /// Simulate function
+    /// Precondition: Every index in order must be a valid step index.
+    /// Postcondition: The steps are run on stock in the given order, and the
+    /// number of steps that crafted is returned.
+    /// </summary>
+    int simulate(const std::vector<int>& order, Stock& stock) const;
+};
+
+#endif // !FLOW_H
@@ -9,6 +9,20 @@
  *      of Formula class.
  *
  *      -2024, Feb 3 Ai Sun - Change arrays to map
+ *
+ *      - 2026, Oct 19 - Compute outputs with fixed-point Quantity so
+ *      yields accumulate exactly.
+ *
+ *      - 2026, Oct 19 - Add condition/result accessors and the
+ *      expected produce rate.
+ *
+ *      - 2026, Oct 19 - Add craft() driven by a Random stream for
+ *      resumable simulations.
+ *
+ *      - 2026, Oct 19 - Produce rates come from a TierTable of any
+ *      size, sampled in constant time through its alias tables.
+ *
+ *      - 2026, Oct 19 - Add allocation tracking scopes.
  */
 
 /*
@@ -24,6 +38,11 @@
  * The Formula class maintains two maps, one for the input materials and their
  * quantities, and one for the output materials and their quantities.
  * The quantities of materials must always be non-negative.
+ * Produce rates and outputs are fixed-point Quantity values, so adding the
+ * outputs of any number of crafts into an inventory is exact.
+ * The tier table and the sampling data of the current proficiency level are
+ * shared, immutable objects, so copying a formula copies two pointers and
+ * increase() only looks up (or builds once) the next level.
  * The Formula class ensures that the maps are properly updated when the
  * proficiency level is increased or the formula is applied.
  *
@@ -41,14 +60,18 @@
  */
 
 #include "formula.h"
+#include "allocation.h"
 #include <stdexcept>
 #include <map>
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 Formula::Formula(const std::string inNames[], const int inQuantities[], int inNum,
-                 const std::string outNames[], const int outQuantities[], int outNum)
+                 const std::string outNames[], const int outQuantities[], int outNum,
+                 std::shared_ptr<const TierTable> tierTable)
+        : tiers(std::move(tierTable))
 {
     // Error handle
     if (outNum == DEFAULT || inNum == DEFAULT)
@@ -79,8 +102,13 @@ Formula::Formula(const std::string inNames[], const int inQuantities[], int inNu
         result[outNames[i]] = outQuantities[i];
     }
 
+    if (!tiers)
+        throw std::invalid_argument
+                ("tier table shouldn't be null.");
+
     // initialize proficiency level
     proficiency = DEFAULT;
+    level = tiers->at(proficiency);
 
 }
 
@@ -89,19 +117,36 @@ int Formula::getProficiency() const
     return proficiency;
 }
 
+const std::map<std::string, int>& Formula::getCondition() const
+{
+    return condition;
+}
+
+const std::map<std::string, int>& Formula::getResult() const
+{
+    return result;
+}
+
+Quantity Formula::expectedRate() const
+{
+    return level->expected;
+}
+
+const std::shared_ptr<const TierTable>& Formula::getTiers() const
+{
+    return tiers;
+}
+
 void Formula::increase() {
-    const int BUFF[] = {0, 5, 6, 3};
+    // look up the next level first so a failure changes nothing
+    level = tiers->at(proficiency + 1);
     proficiency++;
-    
-    // change produce rate
-    for (int i = DEFAULT; i < TYPE; ++i) {
-        probability[(i)] -= BUFF[i];
-    }
-
 }
 
 std::string Formula::toString()
 {
+    ALLOCATION_SCOPE("Formula::toString");
+
     std::ostringstream os;              // holds string
 
     // condition to string
@@ -123,32 +168,25 @@ std::string Formula::toString()
     return os.str();
 }
 
-std::string Formula::apply()
+Quantity Formula::select(unsigned long long draw) const
 {
-    std::ostringstream os;
-
-    const int INDEX = 1, MAX = 100;
-
-    double rate;
-
-    int randomNumber = rand() % MAX;
-
-    for (int i = DEFAULT; i < TYPE; i++) {
-        // if is the last one
-        if (i == TYPE - INDEX) {
+    return tiers->getTier(level->sampler.sample(draw)).rate;
+}
 
-            if (randomNumber >= probability[(i)])
-                rate =  produceRate[(i)];
+std::string Formula::apply()
+{
+    ALLOCATION_SCOPE("Formula::apply");
 
-        }
-        else if (randomNumber >= probability[(i)] &&
-        randomNumber < probability[(i + INDEX)]) {
+    std::ostringstream os;
 
-            rate =  produceRate[(i)];
+    const int BITS = 64, RAND_BITS = 15;
 
-        }
+    // rand() has at least 15 random bits; combine calls into 64 bits
+    unsigned long long randomNumber = 0;
+    for (int bits = DEFAULT; bits < BITS; bits += RAND_BITS)
+        randomNumber = (randomNumber << RAND_BITS) ^ static_cast<unsigned>(rand());
 
-    }
+    Quantity rate = select(randomNumber);
 
     std::cout << randomNumber << std::endl;
 
@@ -161,7 +199,7 @@ std::string Formula::apply()
         // result to string
         for (auto it = result.begin(); it != result.end(); ++it) {
 
-            int temp = it->second;
+            Quantity temp = it->second;
 
             os << temp * rate << " " << it->first;
 
@@ -179,4 +217,29 @@ std::string Formula::apply()
     return os.str();
 }
 
+void Formula::collect(const Quantity& rate, Inventory& inventory) const
+{
+    for (auto it = result.begin(); it != result.end(); ++it) {
+        inventory[it->first] += rate * it->second;
+    }
+}
+
+bool Formula::craft(Random& rng, Inventory& inventory) const
+{
+    // every input must be in stock before anything is consumed
+    for (auto it = condition.begin(); it != condition.end(); ++it) {
+        auto stock = inventory.find(it->first);
+        if (stock == inventory.end() || stock->second < it->second)
+            return false;
+    }
+
+    for (auto it = condition.begin(); it != condition.end(); ++it) {
+        inventory[it->first] -= it->second;
+    }
+
+    collect(select(rng.next()), inventory);
+
+    return true;
+}
+
 Formula::~Formula() = default;
\ No newline at end of file
@@ -9,10 +9,20 @@
 /*      - 2024, Feb 1 Ai Sun - Initial creation of the class.
  *      - 2024, Feb 2 Ai Sun - Delete inner class Material, change the structure
  *      of Formula class.
+ *      - 2026, Oct 19 - Produce rates and outputs use fixed-point
+ *      Quantity instead of double.
+ *      - 2026, Oct 19 - Add accessors for the ratio solver.
+ *      - 2026, Oct 19 - Add craft() and checkpoint access.
+ *      - 2026, Oct 19 - Replace the four fixed produce rates with a
+ *      TierTable of any size sampled through alias tables.
  */
 
 #include<string>
 #include<map>
+#include<memory>
+#include "quantity.h"
+#include "random.h"
+#include "tiers.h"
 
 /// <summary>
 /// Class representing a formula.
@@ -29,14 +39,11 @@ private:
     // holds output resource names and corresponding quantities
     std::map<std::string, int> result;
 
-    // numbers of produce rate type
-    static const int TYPE = 4;
+    // produce rate types and their chances (shared between formulas)
+    std::shared_ptr<const TierTable> tiers;
 
-    // produce rate
-    const double produceRate[TYPE] = { 0, 0.75, 1, 1.1 };
-
-    // default probability of all produce rate
-    double probability[TYPE] = { 0, 25, 45, 95 };
+    // sampling data of the current proficiency level (shared as well)
+    std::shared_ptr<const TierTable::Level> level;
 
     // holds proficiency level
     int proficiency;
@@ -44,20 +51,32 @@ private:
     // default constant value
     const int DEFAULT = 0;
 
+    // returns the produce rate selected by a uniform 64-bit random number
+    Quantity select(unsigned long long draw) const;
+
+    // creates an empty formula for Checkpoint to fill in
+    Formula() = default;
+
+    friend class Checkpoint;
+
 public:
     /// <summary>
     /// Constructor
     /// Precondition: inNames, inQuantities, outNames, outQuantities must not be empty,
-    /// inNum and outNum must be non-negative, inQuantities and outQuantities must be positive.
-    /// Postcondition: A Formula object is created with given input and output materials.
+    /// inNum and outNum must be non-negative, inQuantities and outQuantities must be positive,
+    /// tierTable must not be null.
+    /// Postcondition: A Formula object is created with given input and output materials
+    /// whose produce rates follow tierTable (the standard four rates by default).
     /// </summary>
     Formula(const std::string inNames[], const int inQuantities[], int inNum,
-            const std::string outNames[], const int outQuantities[], int outNum);
+            const std::string outNames[], const int outQuantities[], int outNum,
+            std::shared_ptr<const TierTable> tierTable = TierTable::standard());
 
     /// <summary>
     /// Increase function
-    /// Precondition: None.
-    /// Postcondition: The proficiency level of the Formula object is increased by 1.
+    /// Precondition: Some tier weight must stay positive at the next level.
+    /// Postcondition: The proficiency level of the Formula object is increased by 1,
+    /// and the chances of its produce rates move to that level.
     /// </summary>
     void increase();
 
@@ -68,6 +87,35 @@ public:
     /// </summary>
     int getProficiency() const;
 
+    /// <summary>
+    /// Get Condition function
+    /// Precondition: None.
+    /// Postcondition: The input material names and quantities are returned.
+    /// </summary>
+    const std::map<std::string, int>& getCondition() const;
+
+    /// <summary>
+    /// Get Result function
+    /// Precondition: None.
+    /// Postcondition: The output material names and quantities are returned.
+    /// </summary>
+    const std::map<std::string, int>& getResult() const;
+
+    /// <summary>
+    /// Expected Rate function
+    /// Precondition: None.
+    /// Postcondition: The produce rate averaged over the chances of the tiers
+    /// at the current proficiency level is returned.
+    /// </summary>
+    Quantity expectedRate() const;
+
+    /// <summary>
+    /// Get Tiers function
+    /// Precondition: None.
+    /// Postcondition: The tier table of the produce rates is returned.
+    /// </summary>
+    const std::shared_ptr<const TierTable>& getTiers() const;
+
     /// <summary>
     /// Apply function
     /// Precondition: None.
@@ -76,6 +124,24 @@ public:
     /// </summary>
     std::string apply();
 
+    /// <summary>
+    /// Collect function
+    /// Precondition: rate must be non-negative.
+    /// Postcondition: The output materials multiplied by rate are added to
+    /// the totals in inventory.
+    /// </summary>
+    void collect(const Quantity& rate, Inventory& inventory) const;
+
+    /// <summary>
+    /// Craft function
+    /// Precondition: None.
+    /// Postcondition: If inventory holds every input material, the inputs are
+    /// consumed, a produce rate is drawn from rng and the outputs at that
+    /// rate are added to inventory, and true is returned. Otherwise nothing
+    /// changes and false is returned.
+    /// </summary>
+    bool craft(Random& rng, Inventory& inventory) const;
+
     /// <summary>
     /// To String function
     /// Precondition: None.
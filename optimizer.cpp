@@ -0,0 +1,454 @@
+#include "optimizer.h"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/*
+ * This is the implementation of optimizer.h. PlanOptimizer searches for a run
+ * order of the steps of a plan that stalls less and leaves more of a target
+ * (or fewer idle inputs) than the order the plan was written in.
+ *
+ * Implementation Invariant:
+ * A search node is a partial order: the stock after running it, how often
+ * each step has been placed, its score and the most its score can still
+ * rise (potential). A step placed while it can run crafts; a step that
+ * can't run yet may also be placed, which stalls it for good (its one way
+ * to be skipped). Every step changes the score by a fixed gain, so a child is
+ * scored from its parent without copying anything; only the beamWidth best
+ * children of each depth are built. A node is complete when no step that
+ * was never placed can run: appending those steps at the end changes
+ * nothing. Nodes are identified by a 64-bit hash that is a sum of one term
+ * per material stock and per step count, updated in O(inputs + outputs) per
+ * child; children with equal hashes are taken to be the same state.
+ * Parents are expanded and children built on several threads, each over its
+ * own range of the beam, and candidates are ranked by a total order, so the
+ * result doesn't depend on the number of threads.
+ *
+ * Error Processing:
+ * maximize throws an std::invalid_argument exception for a target no step
+ * uses, and both searches for bad options.
+ *
+ * Assumptions:
+ * Produce rates are those of FlowModel. A hash collision between two
+ * different states (odds about 2^-64 per pair) would drop one of them.
+ */
+
+namespace
+{
+    const unsigned long long GOLDEN = 0x9E3779B97F4A7C15ULL;
+
+    // work (nodes times steps) per thread below which a depth stays on one
+    // thread; starting a thread costs about as much as this many checks
+    const std::size_t PARALLEL_WORK = 1 << 15;
+
+    // splitmix64 finalizer
+    unsigned long long mix(unsigned long long x)
+    {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // hash term of a material stock
+    unsigned long long itemHash(int item, long long stock)
+    {
+        return mix(static_cast<unsigned long long>(stock) +
+                   GOLDEN * (2ULL * item + 1));
+    }
+
+    // hash term of how often a step is placed
+    unsigned long long useHash(int step, int uses)
+    {
+        return mix(static_cast<unsigned long long>(uses) +
+                   GOLDEN * (2ULL * step + 2));
+    }
+
+    // a partial order
+    struct Node
+    {
+        FlowModel::Stock stock;
+        std::vector<int> uses;
+        long long score;
+        long long potential;
+        unsigned long long hash;
+        int placed;             // steps placed at least once
+        int trail;              // last entry of the order in the trail list
+    };
+
+    // a child of a node that is not built yet
+    struct Candidate
+    {
+        int parent;
+        int step;
+        bool stall;             // placed while it can't run
+        long long score;
+        long long bound;
+        int placed;
+        unsigned long long hash;
+    };
+
+    // best first, preferring to place new steps over repeating placed ones
+    // and running over stalling, then a fixed order so ties break the same
+    // way every time
+    bool better(const Candidate& a, const Candidate& b)
+    {
+        if (a.score != b.score)
+            return a.score > b.score;
+        if (a.bound != b.bound)
+            return a.bound > b.bound;
+        if (a.placed != b.placed)
+            return a.placed > b.placed;
+        if (a.stall != b.stall)
+            return b.stall;
+        if (a.parent != b.parent)
+            return a.parent < b.parent;
+        return a.step < b.step;
+    }
+
+    // runs work(first, last) over [0, count) split across up to workers
+    // threads, where each of the count items costs about cost
+    template <typename Work>
+    void split(std::size_t count, std::size_t cost, std::size_t workers,
+               Work work)
+    {
+        workers = std::min(workers, count * cost / PARALLEL_WORK + 1);
+
+        std::vector<std::thread> threads;
+        const std::size_t chunk = (count + workers - 1) / workers;
+        for (std::size_t w = 1; w < workers; ++w)
+        {
+            const std::size_t first = std::min(count, w * chunk);
+            const std::size_t last = std::min(count, first + chunk);
+            threads.emplace_back([=]() { work(first, last); });
+        }
+        work(0, std::min(count, chunk));
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+}
+
+// Constructor
+PlanOptimizer::PlanOptimizer(const PlanView& plan, const Inventory& inventory)
+        : model(plan), start(model.stock(inventory))
+{
+}
+
+// Maximize function
+Ordering PlanOptimizer::maximize(const std::string& target,
+                                 const OrderingOptions& options) const
+{
+    const int item = model.find(target);
+    if (item == FlowModel::NONE)
+        throw std::invalid_argument("No step uses the target " + target + ".");
+
+    return search(TARGET, item, options);
+}
+
+// Minimize leftover function
+Ordering PlanOptimizer::minimizeLeftover(const OrderingOptions& options) const
+{
+    return search(LEFTOVER, FlowModel::NONE, options);
+}
+
+// Search function
+Ordering PlanOptimizer::search(Objective objective, int target,
+                               const OrderingOptions& options) const
+{
+    if (options.beamWidth <= 0 || options.repeats <= 0 ||
+        options.budget <= 0 || options.threads < 0)
+        throw std::invalid_argument("Search options should be positive.");
+
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(options.budget);
+    const std::size_t workers = options.threads > 0 ? options.threads :
+            std::max(1u, std::thread::hardware_concurrency());
+
+    const int steps = model.getSize();
+    const int items = model.getItemCount();
+
+    // net change of each step by material, and the materials steps consume
+    std::vector<std::vector<FlowModel::Entry>> net(steps);
+    std::vector<char> consumed(items, 0);
+    std::vector<long long> change(items, 0);
+    for (int s = 0; s < steps; ++s)
+    {
+        for (const FlowModel::Entry& input : model.getInputs(s))
+        {
+            change[input.item] -= input.amount;
+            consumed[input.item] = 1;
+        }
+        for (const FlowModel::Entry& output : model.getOutputs(s))
+            change[output.item] += output.amount;
+
+        for (const FlowModel::Entry& input : model.getInputs(s))
+        {
+            net[s].push_back(FlowModel::Entry{ input.item,
+                                               change[input.item] });
+            change[input.item] = 0;
+        }
+        for (const FlowModel::Entry& output : model.getOutputs(s))
+        {
+            if (change[output.item] != 0)
+                net[s].push_back(FlowModel::Entry{ output.item,
+                                                   change[output.item] });
+            change[output.item] = 0;
+        }
+    }
+
+    // score of a stock, higher is better
+    auto score = [&](const FlowModel::Stock& stock)
+    {
+        long long total = 0;
+        if (objective == TARGET)
+            return stock[target];
+        for (int i = 0; i < items; ++i)
+        {
+            if (consumed[i])
+                total -= stock[i];
+        }
+        return total;
+    };
+
+    // fixed score change of each step
+    std::vector<long long> gain(steps, 0);
+    long long potential = 0;
+    for (int s = 0; s < steps; ++s)
+    {
+        for (const FlowModel::Entry& change : net[s])
+        {
+            if (objective == TARGET && change.item == target)
+                gain[s] += change.amount;
+            else if (objective == LEFTOVER && consumed[change.item])
+                gain[s] -= change.amount;
+        }
+        potential += std::max(gain[s], 0LL) * options.repeats;
+    }
+
+    // the most a score plus potential can reach
+    auto cap = [&](long long bound)
+    {
+        return objective == LEFTOVER ? std::min(bound, 0LL) : bound;
+    };
+
+    // order of a node: its trail, then the steps it never placed
+    std::vector<std::pair<int, int>> trails;    // (previous entry, step)
+    auto orderOf = [&](const Node& node)
+    {
+        std::vector<int> order;
+        for (int t = node.trail; t >= 0; t = trails[t].first)
+            order.push_back(trails[t].second);
+        std::reverse(order.begin(), order.end());
+        for (int s = 0; s < steps; ++s)
+        {
+            if (node.uses[s] == 0)
+                order.push_back(s);
+        }
+        return order;
+    };
+
+    // the plan's own order is the first complete order
+    Ordering best;
+    long long bestScore;
+    {
+        for (int s = 0; s < steps; ++s)
+            best.order.push_back(s);
+        FlowModel::Stock stock = start;
+        model.simulate(best.order, stock);
+        bestScore = score(stock);
+    }
+
+    std::vector<Node> beam(1);
+    beam[0].stock = start;
+    beam[0].uses.assign(steps, 0);
+    beam[0].score = score(start);
+    beam[0].potential = potential;
+    beam[0].hash = 0;
+    beam[0].placed = 0;
+    beam[0].trail = -1;
+    for (int i = 0; i < items; ++i)
+        beam[0].hash += itemHash(i, start[i]);
+    for (int s = 0; s < steps; ++s)
+        beam[0].hash += useHash(s, 0);
+
+    best.finished = true;
+    while (!beam.empty())
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            best.finished = false;
+            break;
+        }
+
+        // score every child of every node
+        std::vector<std::vector<Candidate>> found(beam.size());
+        std::vector<char> complete(beam.size(), 0);
+        const long long floor = bestScore;
+        split(beam.size(), steps, workers, [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t p = first; p < last; ++p)
+            {
+                const Node& node = beam[p];
+                std::vector<char> runnable(steps);
+                bool open = false;
+                for (int s = 0; s < steps; ++s)
+                {
+                    runnable[s] = node.uses[s] < options.repeats &&
+                                  model.canRun(s, node.stock);
+                    if (runnable[s] && node.uses[s] == 0)
+                        open = true;
+                }
+
+                for (int s = 0; s < steps; ++s)
+                {
+                    // a step that can't run yet may be placed to stall it,
+                    // unless every unplaced step is stalled anyway
+                    const bool stall = !runnable[s] && node.uses[s] == 0;
+                    if (!runnable[s] && !(stall && open))
+                        continue;
+
+                    Candidate child;
+                    child.parent = static_cast<int>(p);
+                    child.step = s;
+                    child.stall = stall;
+                    child.placed = node.placed + (node.uses[s] == 0 ? 1 : 0);
+                    child.score = node.score + (stall ? 0 : gain[s]);
+                    child.bound = cap(node.score + node.potential -
+                                      std::max(gain[s], 0LL) +
+                                      (stall ? 0 : gain[s]));
+                    if (child.bound <= floor)
+                        continue;
+
+                    child.hash = node.hash - useHash(s, node.uses[s]) +
+                                 useHash(s, node.uses[s] + 1);
+                    if (!stall)
+                    {
+                        for (const FlowModel::Entry& change : net[s])
+                        {
+                            const long long stock = node.stock[change.item];
+                            child.hash += itemHash(change.item,
+                                                   stock + change.amount) -
+                                          itemHash(change.item, stock);
+                        }
+                    }
+                    found[p].push_back(child);
+                }
+                complete[p] = !open;
+            }
+        });
+
+        for (std::size_t p = 0; p < beam.size(); ++p)
+        {
+            if (complete[p] && beam[p].score > bestScore)
+            {
+                bestScore = beam[p].score;
+                best.order = orderOf(beam[p]);
+            }
+        }
+
+        // keep the best distinct children that can still win
+        std::vector<Candidate> ranked;
+        for (const std::vector<Candidate>& children : found)
+        {
+            for (const Candidate& child : children)
+            {
+                if (child.bound > bestScore)
+                    ranked.push_back(child);
+            }
+        }
+
+        // rank only as many as needed, widening when duplicates crowd in
+        const std::size_t width = options.beamWidth;
+        std::vector<Candidate> chosen;
+        for (std::size_t ranks = std::min(ranked.size(), 2 * width);;
+             ranks = std::min(ranked.size(), 4 * ranks))
+        {
+            std::partial_sort(ranked.begin(), ranked.begin() + ranks,
+                              ranked.end(), better);
+
+            chosen.clear();
+            std::unordered_set<unsigned long long> seen;
+            for (std::size_t c = 0; c < ranks && chosen.size() < width; ++c)
+            {
+                if (seen.insert(ranked[c].hash).second)
+                    chosen.push_back(ranked[c]);
+            }
+            if (chosen.size() == width || ranks == ranked.size())
+                break;
+        }
+
+        // build them
+        std::vector<Node> next(chosen.size());
+        const int base = static_cast<int>(trails.size());
+        for (const Candidate& child : chosen)
+            trails.emplace_back(beam[child.parent].trail, child.step);
+
+        split(chosen.size(), steps + items, workers, [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t c = first; c < last; ++c)
+            {
+                const Candidate& child = chosen[c];
+                const Node& parent = beam[child.parent];
+                Node& node = next[c];
+
+                node.stock = parent.stock;
+                model.run(child.step, node.stock);
+                node.uses = parent.uses;
+                node.uses[child.step]++;
+                node.score = child.score;
+                node.potential = parent.potential -
+                                 std::max(gain[child.step], 0LL);
+                node.hash = child.hash;
+                node.placed = child.placed;
+                node.trail = base + static_cast<int>(c);
+            }
+        });
+
+        beam.swap(next);
+    }
+
+    // out of time: finish what is left of the beam in plan order
+    for (const Node& node : beam)
+    {
+        std::vector<int> order = orderOf(node);
+        FlowModel::Stock stock = start;
+        model.simulate(order, stock);
+        if (score(stock) > bestScore)
+        {
+            bestScore = score(stock);
+            best.order.swap(order);
+        }
+    }
+
+    best.score = Quantity::fromRaw(objective == TARGET ? bestScore
+                                                        : -bestScore);
+
+    return best;
+}
+
+// Result function
+Inventory PlanOptimizer::result(const std::vector<int>& order) const
+{
+    FlowModel::Stock stock = start;
+    model.simulate(order, stock);
+
+    return model.inventory(stock);
+}
+
+// Reorder function
+Plan PlanOptimizer::reorder(const Plan& plan, const std::vector<int>& order)
+{
+    Plan reordered;
+    reordered.Reserve(static_cast<int>(order.size()));
+
+    for (int step : order)
+        reordered.Append(plan.view(step, step + 1));
+
+    return reordered;
+}
@@ -0,0 +1,114 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "flow.h"
+#include "plan.h"
+#include "quantity.h"
+#include <string>
+#include <vector>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/// <summary>
+/// Search settings of PlanOptimizer.
+/// beamWidth is the number of partial orders kept at each depth, repeats
+/// the most times a step may appear in the order, threads the number of
+/// threads (0 for one per core) and budget the time limit in milliseconds.
+/// </summary>
+struct OrderingOptions
+{
+    int beamWidth = 64;
+    int repeats = 1;
+    int threads = 0;
+    int budget = 1000;
+};
+
+/// <summary>
+/// Result of an ordering search.
+/// order holds step indices of the plan in run order; every step appears at
+/// least once. score is the target stock (maximize) or the leftover stock
+/// (minimizeLeftover) that the order leaves. finished is false if the time
+/// budget ran out before the search did.
+/// </summary>
+struct Ordering
+{
+    std::vector<int> order;
+    Quantity score;
+    bool finished;
+};
+
+/// <summary>
+/// Class representing a step-ordering optimizer for a Plan.
+/// Steps are ordered by a beam search with branch-and-bound pruning over the
+/// deterministic FlowModel of the plan, starting from a given inventory.
+/// Each depth of the search places one more step; partial orders that reach
+/// the same stock with the same steps placed are merged, and those whose
+/// best possible score can't beat the best complete order are dropped.
+/// The plan's own order is the first complete order, so the result is never
+/// worse than it.
+/// Class Invariant: The model matches the plan the optimizer was built from.
+/// </summary>
+class PlanOptimizer
+{
+private:
+    // what a search scores
+    enum Objective { TARGET, LEFTOVER };
+
+    FlowModel model;
+    FlowModel::Stock start;
+
+    // runs the search for objective (target is used for TARGET only)
+    Ordering search(Objective objective, int target,
+                    const OrderingOptions& options) const;
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: None.
+    /// Postcondition: An optimizer for the steps of plan starting from
+    /// inventory is created.
+    /// </summary>
+    PlanOptimizer(const PlanView& plan, const Inventory& inventory);
+
+    /// <summary>
+    /// Maximize function
+    /// Precondition: options must have a positive beam width, repeats and
+    /// budget, and a non-negative thread count.
+    /// Postcondition: The best order found for the most target stock is
+    /// returned.
+    /// </summary>
+    Ordering maximize(const std::string& target,
+                      const OrderingOptions& options = OrderingOptions()) const;
+
+    /// <summary>
+    /// Minimize Leftover function
+    /// Precondition: As for maximize.
+    /// Postcondition: The best order found for the least leftover stock is
+    /// returned. Leftover stock is the stock of every material some step
+    /// consumes, i.e. inputs left idle.
+    /// </summary>
+    Ordering minimizeLeftover
+            (const OrderingOptions& options = OrderingOptions()) const;
+
+    /// <summary>
+    /// Result function
+    /// Precondition: Every index in order must be a valid step index.
+    /// Postcondition: The stock of every material of the plan left after
+    /// running order from the start inventory with expected produce rates is
+    /// returned.
+    /// </summary>
+    Inventory result(const std::vector<int>& order) const;
+
+    /// <summary>
+    /// Reorder function
+    /// Precondition: Every index in order must be a valid step index of
+    /// plan.
+    /// Postcondition: A plan holding copies of the steps of plan in the
+    /// given order is returned.
+    /// </summary>
+    static Plan reorder(const Plan& plan, const std::vector<int>& order);
+};
+
+#endif // !OPTIMIZER_H
@@ -1,7 +1,24 @@
 #include <iostream>
 #include "plan.h"
 #include "formula.h"
+#include "solver.h"
+#include "checkpoint.h"
+#include "catalog.h"
+#include "server.h"
+#include "exporter.h"
+#include "random.h"
+#include "allocation.h"
+#include "optimizer.h"
+#include "campaign.h"
+#include "sensitivity.h"
 #include <vector>
+#include <climits>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <chrono>
 
 /// Author: Ai Sun
 ///   Date: 2023, Feb 2
@@ -67,12 +84,44 @@ const std::string cookies[] = {"cookies"};
 int cookiesQty[] = {36};
 int cookiesCnt = 1;
 
+// 1 iron bar -> 1 tool, 2 iron ore -> 2 iron bar, 1 iron ore -> 1 iron bar
+const std::string tool[] = {"tool"};
+int toolQty[] = {1};
+int toolCnt = 1;
+
+int twoBarsQty[] = {2};
+int oneOreQty[] = {1};
+
 // Test Formula constructor
 Formula ironBar(ore, oreQty, oreCnt, bar, barQty, barCnt);
 Formula steelBar(oreCoal, oreCoalQty, oreCoalCnt, steel, steelQty, steelCnt);
 Formula plankBrickFormula(woodStone, woodStoneQty, woodStoneCnt, plankBrick, plankBrickQty, plankBrickCnt);
 Formula hydrogenDeuteriumFormula(water, waterQty, waterCnt, hydrogenDeuterium, hydrogenDeuteriumQty, hydrogenDeuteriumCnt);
 Formula cookiesFormula(ingredients, ingredientsQty, ingredientsCnt, cookies, cookiesQty, cookiesCnt);
+Formula forge(bar, barQty, barCnt, tool, toolQty, toolCnt);
+Formula smelter(ore, oreQty, oreCnt, bar, twoBarsQty, barCnt);
+Formula quickSmelter(ore, oneOreQty, oreCnt, bar, barQty, barCnt);
+
+void check(const std::string& what, bool passed) {
+    /*
+     * Description: Reports one checked condition.
+     * Input: A description of the condition and whether it held.
+     * Modify: None.
+     * Output: Prints the description followed by ok or FAILED.
+     */
+    std::cout << what << (passed ? " ... ok" : " ... FAILED") << std::endl;
+}
+
+bool near(double value, double expected) {
+    /*
+     * Description: Compares two rates.
+     * Input: A computed and an expected value.
+     * Modify: None.
+     * Output: Returns true if they agree to nine significant digits.
+     */
+    return std::fabs(value - expected) <=
+           1e-9 * std::max(1.0, std::fabs(expected));
+}
 
 void testPlanConstructor() {
     /*
@@ -292,6 +341,677 @@ void testCopyByAssignment() {
     std::cout << "Copy by assignment: \n" << planCopy.toString() << std::endl;
 }
 
+void testQuantity() {
+    /*
+     * Description: Tests the Quantity class.
+     * Input: None.
+     * Modify: Rounds, multiplies and divides quantities, collects the
+     * outputs of a Formula many times, and triggers the overflow and
+     * division exceptions.
+     * Output: Prints each result with whether it matched, and the
+     * exception messages.
+     */
+    std::cout << "----------Test Quantity----------" << std::endl;
+    const Quantity half = Quantity::fromRaw(1);     // 0.0001
+
+    // half a raw unit rounds away from zero
+    check("ratio(2, 3) = " + Quantity::ratio(2, 3).toString(),
+          Quantity::ratio(2, 3).getRaw() == 6667);
+    check("ratio(1, 20000) = " + Quantity::ratio(1, 20000).toString(),
+          Quantity::ratio(1, 20000).getRaw() == 1);
+    check("ratio(1, -20000) = " + Quantity::ratio(1, -20000).toString(),
+          Quantity::ratio(1, -20000).getRaw() == -1);
+    check("0.0005 * 0.5 = " + (Quantity::fromRaw(5) * Quantity::ratio(1, 2))
+                  .toString(),
+          (Quantity::fromRaw(5) * Quantity::ratio(1, 2)).getRaw() == 3);
+    check("-0.0005 * 0.5 = " + (Quantity::fromRaw(-5) * Quantity::ratio(1, 2))
+                  .toString(),
+          (Quantity::fromRaw(-5) * Quantity::ratio(1, 2)).getRaw() == -3);
+    check("0.0001 / 2 = " + (half / 2).toString(), (half / 2).getRaw() == 1);
+    check("-0.0001 / 2 = " + (-half / 2).toString(),
+          (-half / 2).getRaw() == -1);
+    check("1 / 3 = " + (Quantity(1) / 3).toString(),
+          (Quantity(1) / 3).getRaw() == 3333);
+
+    // the most negative value has no positive counterpart
+    check("LLONG_MIN raw = " + Quantity::fromRaw(LLONG_MIN).toString(),
+          Quantity::fromRaw(LLONG_MIN).toString() == "-922337203685477.5808");
+
+    // 1000 crafts at 0.75 and at 1.1 add up without drift
+    Inventory inventory;
+    for (int i = 0; i < 1000; ++i) {
+        hydrogenDeuteriumFormula.collect(Quantity::ratio(3, 4), inventory);
+        hydrogenDeuteriumFormula.collect(Quantity::ratio(11, 10), inventory);
+    }
+    check("1000 collects: " + inventory["hydrogen"].toString() + " hydrogen, "
+                  + inventory["deuterium"].toString() + " deuterium",
+          inventory["hydrogen"] == Quantity(1848150) &&
+          inventory["deuterium"] == Quantity(1850));
+
+    try {
+        Quantity big(LLONG_MAX / 1000);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    try {
+        Quantity::fromRaw(LLONG_MAX) + half;
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    try {
+        Quantity::fromRaw(LLONG_MAX) * Quantity(2);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    try {
+        Quantity(1) / Quantity(0);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    try {
+        Quantity::ratio(1, 0);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+}
+
+void testRatioSolver() {
+    /*
+     * Description: Tests the RatioSolver class.
+     * Input: None.
+     * Modify: Solves a two-output formula for both outputs, a formula with a
+     * catalyst, and a loop of two formulas.
+     * Output: Prints each rate with whether it matched the expected one.
+     */
+    std::cout << "----------Test ratio solver----------" << std::endl;
+    const double rate = ironBar.expectedRate().toDouble();
+
+    // both outputs of one formula: the larger demand decides
+    Formula* waterSequences[] = {&hydrogenDeuteriumFormula};
+    RatioSolver electrolysis(PlanView(waterSequences, 1));
+    RatioSolution split = electrolysis.solve({{"hydrogen", 1e6},
+                                              {"deuterium", 1}});
+    check("electrolysis crafts = " + std::to_string(split.crafts[0]),
+          near(split.crafts[0], 1e6 / (999 * rate)));
+    check("hydrogen net = " + std::to_string(split.net["hydrogen"]),
+          near(split.net["hydrogen"], 1e6));
+    check("deuterium net = " + std::to_string(split.net["deuterium"]),
+          split.net["deuterium"] >= 1);
+
+    split = electrolysis.solve({{"hydrogen", 999}, {"deuterium", 10}});
+    check("deuterium-bound crafts = " + std::to_string(split.crafts[0]),
+          near(split.crafts[0], 10 / rate) && near(split.net["deuterium"], 10));
+
+    // 1 ore, 1 catalyst -> 2 bar, 1 catalyst
+    const std::string oreCatalyst[] = {"iron ore", "catalyst"};
+    int oreCatalystQty[] = {1, 1};
+    const std::string barCatalyst[] = {"iron bar", "catalyst"};
+    int barCatalystQty[] = {2, 1};
+    Formula catalystFormula(oreCatalyst, oreCatalystQty, 2,
+                            barCatalyst, barCatalystQty, 2);
+    Formula* catalystSequences[] = {&catalystFormula};
+    RatioSolution catalysed = RatioSolver(PlanView(catalystSequences, 1))
+            .solve({{"iron bar", 3}});
+    check("catalyst crafts = " + std::to_string(catalysed.crafts[0]),
+          near(catalysed.crafts[0], 3 / (2 * rate)));
+    check("catalyst net = " + std::to_string(catalysed.net["catalyst"]),
+          near(catalysed.net["catalyst"], (rate - 1) * 3 / (2 * rate)));
+
+    // 1 seed, 1 water -> 4 plant; 1 plant -> 1 seed, 1 grain
+    const std::string seedWater[] = {"seed", "water"};
+    int seedWaterQty[] = {1, 1};
+    const std::string plant[] = {"plant"};
+    int plantQty[] = {4};
+    int onePlantQty[] = {1};
+    const std::string seedGrain[] = {"seed", "grain"};
+    int seedGrainQty[] = {1, 1};
+    Formula grow(seedWater, seedWaterQty, 2, plant, plantQty, 1);
+    Formula thresh(plant, onePlantQty, 1, seedGrain, seedGrainQty, 2);
+    Formula* loopSequences[] = {&grow, &thresh};
+    RatioSolver farm(PlanView(loopSequences, 2));
+    RatioSolution loop = farm.solve({{"grain", 1}});
+    check("thresh crafts = " + std::to_string(loop.crafts[1]),
+          near(loop.crafts[1], 1 / rate));
+    check("grow crafts = " + std::to_string(loop.crafts[0]),
+          near(loop.crafts[0], 1 / (4 * rate * rate)));
+    check("seed net = " + std::to_string(loop.net["seed"]),
+          near(loop.net["seed"], 1 - 1 / (4 * rate * rate)));
+    check("water net = " + std::to_string(loop.net["water"]),
+          near(loop.net["water"], -1 / (4 * rate * rate)));
+
+    loop = farm.solve({{"seed", 1}});
+    check("seed-only crafts = " + std::to_string(loop.crafts[0]),
+          near(loop.crafts[0], 1 / (4 * rate * rate - 1)));
+}
+
+void testCheckpoint() {
+    /*
+     * Description: Tests the Checkpoint class.
+     * Input: None.
+     * Modify: Saves a simulation state part way through, restores it, runs
+     * both on, and restores a corrupted and a truncated checkpoint.
+     * Output: Prints whether the restored state matched and the exception
+     * messages.
+     */
+    std::cout << "----------Test checkpoint----------" << std::endl;
+
+    // a formula with its own tier table, one level up
+    Tier doublingTiers[] = {{1, 1, 0}, {2, 1, 1}};
+    std::shared_ptr<const TierTable> doubling =
+            std::make_shared<const TierTable>(doublingTiers, 2);
+    Formula doubled(ore, oreQty, oreCnt, bar, barQty, barCnt, doubling);
+    doubled.increase();
+
+    int size = 3;
+    Formula* initialSequences[] = {&ironBar, &steelBar, &doubled};
+    SimulationState state;
+    state.plans.emplace_back(initialSequences, size);
+    state.inventories.emplace_back();
+    state.inventories[0]["iron ore"] = 200;
+    state.inventories[0]["coal"] = 20;
+    state.streams.emplace_back(42);
+    state.plans[0].simulate(state.streams[0], state.inventories[0]);
+
+    const std::string blob = Checkpoint::save(state);
+    SimulationState restored = Checkpoint::restore(blob);
+    check("re-saved checkpoint is identical",
+          Checkpoint::save(restored) == blob);
+    check("restored formula keeps its level",
+          restored.plans[0].getFormula(2).getProficiency() == 1);
+
+    bool same = true;
+    for (int round = 0; round < 10; ++round) {
+        int crafted = state.plans[0].simulate(state.streams[0],
+                                              state.inventories[0]);
+        int again = restored.plans[0].simulate(restored.streams[0],
+                                               restored.inventories[0]);
+        same = same && crafted == again &&
+               state.inventories[0] == restored.inventories[0];
+    }
+    check("restored simulation continues identically (iron bar "
+                  + state.inventories[0]["iron bar"].toString() + ")",
+          same && state.streams[0].next() == restored.streams[0].next());
+
+    const std::string path = "p2_checkpoint.bin";
+    Checkpoint::saveFile(path, state);
+    check("checkpoint file round trip",
+          Checkpoint::save(Checkpoint::restoreFile(path)) ==
+          Checkpoint::save(state));
+    std::remove(path.c_str());
+
+    try {
+        std::string corrupted = blob;
+        corrupted[corrupted.size() / 2] ^= 1;
+        Checkpoint::restore(corrupted);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    try {
+        Checkpoint::restore(blob.substr(0, blob.size() / 2));
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+}
+
+void testCatalogReload() {
+    /*
+     * Description: Tests reloading a Catalog while a snapshot is held.
+     * Input: None.
+     * Modify: Acquires a snapshot, reloads the catalog from a Plan and from
+     * checkpoint files, one of which holds no plan.
+     * Output: Prints whether the held snapshot stayed unchanged and the
+     * versions increased, and the exception message.
+     */
+    std::cout << "----------Test catalog reload----------" << std::endl;
+    int size = 2;
+    Formula* initialSequences[] = {&ironBar, &steelBar};
+    Catalog catalog{Plan(initialSequences, size)};
+
+    std::shared_ptr<const CatalogSnapshot> held = catalog.acquire();
+    Formula* otherSequences[] = {&cookiesFormula};
+    unsigned long long version = catalog.reload(Plan(otherSequences, 1));
+
+    check("held snapshot unchanged (version "
+                  + std::to_string(held->version) + ", "
+                  + std::to_string(held->formulas.getSize()) + " formulas)",
+          held->version == 1 && held->formulas.getSize() == 2 &&
+          held->formulas.getFormula(1).getResult().count("steel bar") == 1);
+    check("reload published version " + std::to_string(version),
+          version == 2 && catalog.acquire()->version == 2 &&
+          catalog.acquire()->formulas.getSize() == 1);
+
+    const std::string path = "p2_catalog.bin";
+    SimulationState state;
+    state.plans.emplace_back(initialSequences, size);
+    Checkpoint::saveFile(path, state);
+    version = catalog.reloadFile(path);
+    check("reload from file published version " + std::to_string(version),
+          version == 3 && catalog.acquire()->formulas.getSize() == 2);
+
+    // a checkpoint without a plan leaves the catalog as it was
+    Checkpoint::saveFile(path, SimulationState());
+    try {
+        catalog.reloadFile(path);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+    check("failed reload kept version "
+                  + std::to_string(catalog.acquire()->version),
+          catalog.acquire()->version == 3 && held->version == 1);
+    std::remove(path.c_str());
+}
+
+void testServer() {
+    /*
+     * Description: Tests a SimulationServer round trip over its socket.
+     * Input: None.
+     * Modify: Serves a two-formula catalog on a thread and sends it a bill of
+     * materials, a simulation, and simulations with a bad step index and
+     * too many crafts.
+     * Output: Prints whether the answers matched local ones, and the
+     * exception messages of the failed requests.
+     */
+    std::cout << "----------Test simulation server----------" << std::endl;
+    const std::string path = "p2_server.sock";
+    Formula* initialSequences[] = {&ironBar, &steelBar};
+    Catalog catalog{Plan(initialSequences, 2)};
+    std::shared_ptr<const CatalogSnapshot> snapshot = catalog.acquire();
+
+    SimulationServer server(catalog, path);
+    std::thread serving(&SimulationServer::run, &server);
+
+    try {
+        SimulationClient client(path);
+
+        RatioSolution bill = client.billOfMaterials({{"steel bar", 2}});
+        RatioSolution local = snapshot->solver.solve({{"steel bar", 2}});
+        check("bill crafts = " + std::to_string(bill.crafts[1]),
+              bill.crafts.size() == 2 && bill.crafts[0] == 0 &&
+              near(bill.crafts[1], local.crafts[1]) &&
+              near(bill.net["coal"], local.net["coal"]));
+
+        Inventory inventory = {{"iron ore", Quantity(9)}};
+        Inventory expected = inventory;
+        long long crafted = client.simulate(5, 3, {0}, inventory);
+        Random rng(5);
+        long long localCrafted = 0;
+        for (int r = 0; r < 3; ++r)
+            localCrafted += snapshot->formulas.getFormula(0).craft(rng,
+                                                                   expected);
+        check("simulation crafted " + std::to_string(crafted),
+              crafted == localCrafted && inventory == expected);
+
+        // a failed request is answered, and the connection stays usable
+        std::vector<std::vector<int>> badSteps = {{7}, {0, 1}};
+        std::vector<int> repetitions = {1, INT_MAX};
+        for (std::size_t i = 0; i < badSteps.size(); ++i) {
+            try {
+                client.simulate(1, repetitions[i], badSteps[i], inventory);
+            } catch (std::exception& e) {
+                std::cerr << "Exception caught: " << e.what() << std::endl;
+            }
+        }
+        check("connection usable after failures",
+              client.expectedYield(0).count("iron bar") == 1);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    server.stop();
+    serving.join();
+}
+
+void testPlanExport() {
+    /*
+     * Description: Tests the PlanExporter class.
+     * Input: None.
+     * Modify: Creates a Plan object and streams it in each format.
+     * Output: Prints the plan as text, CSV and JSON.
+     */
+    std::cout << "----------Test Plan export----------" << std::endl;
+    int size = 2;
+    Formula* initialSequences[] = {&plankBrickFormula, &hydrogenDeuteriumFormula};
+    Plan plan(initialSequences, size);
+
+    PlanExporter::Format formats[] = {PlanExporter::TEXT, PlanExporter::CSV,
+                                      PlanExporter::JSON};
+    for (PlanExporter::Format format : formats) {
+        PlanExporter exporter(std::cout, format);
+        exporter.writePlan(plan);
+    }
+    std::cout << std::endl;
+}
+
+void testPlanBulk() {
+    /*
+     * Description: Tests the Plan bulk operations and PlanView.
+     * Input: None.
+     * Modify: Reserves, appends, inserts, erases and splices ranges of
+     * Formula objects, and triggers the range exceptions.
+     * Output: Prints the Plan objects after each operation and the
+     * exception messages.
+     */
+    std::cout << "----------Test Plan bulk operations----------" << std::endl;
+    int size = 2;
+    Formula* initialSequences[] = {&ironBar, &steelBar};
+    Plan plan;
+    plan.Reserve(8);
+    plan.Append(PlanView(initialSequences, size));
+    std::cout << "After append (capacity " << plan.getCapacity() << "):\n"
+              << plan.toString() << std::endl;
+
+    // insert a view of the plan into itself
+    plan.Insert(1, plan.view(0, 2));
+    std::cout << "After insert at index 1:\n" << plan.toString() << std::endl;
+
+    plan.Erase(0, 2);
+    std::cout << "After erase [0, 2):\n" << plan.toString() << std::endl;
+
+    Formula* otherSequences[] = {&cookiesFormula, &plankBrickFormula};
+    Plan other(otherSequences, size);
+    plan.Splice(0, other, 0, 1);
+    std::cout << "After splice of cookies:\n" << plan.toString()
+              << "Source left with:\n" << other.toString() << std::endl;
+
+    try {
+        plan.Erase(1, plan.getSize() + 1);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    try {
+        plan.Splice(0, plan, 0, 1);
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+}
+
+void testTierTable() {
+    /*
+     * Description: Tests the AliasTable and TierTable classes.
+     * Input: None.
+     * Modify: Samples an alias table, raises formulas on the standard table
+     * and on a table whose weights all drop to zero.
+     * Output: Prints whether the sampled frequencies, expected rates and
+     * cached levels matched, and the exception message.
+     */
+    std::cout << "----------Test tier table----------" << std::endl;
+
+    // frequencies follow the weights, and a zero weight is never drawn
+    const int DRAWS = 400000;
+    std::vector<double> weights = {1, 2, 3, 4, 0};
+    AliasTable sampler(weights);
+    std::vector<int> counts(weights.size(), 0);
+    Random rng(11);
+    for (int i = 0; i < DRAWS; ++i)
+        ++counts[sampler.sample(rng.next())];
+
+    bool follows = counts[4] == 0;
+    for (std::size_t i = 0; i < weights.size(); ++i)
+        follows = follows &&
+                  std::fabs(counts[i] / double(DRAWS) - weights[i] / 10) < 0.005;
+    check("alias frequencies follow the weights", follows);
+
+    // the standard table reproduces the old four-tier thresholds, which
+    // moved by 0, 5, 6 and 3 points per level
+    const int THRESHOLD[] = {0, 25, 45, 95};
+    const int BUFF[] = {0, 5, 6, 3};
+    const long long RATE[] = {0, 7500, 10000, 11000};
+    Formula raised(ore, oreQty, oreCnt, bar, barQty, barCnt);
+    check("standard expected rate at level 0 is "
+                  + raised.expectedRate().toString(),
+          raised.expectedRate().toString() == "0.705");
+
+    bool matches = true;
+    for (int level = 0; level <= 5; ++level) {
+        if (level > 0)
+            raised.increase();
+
+        long long raw = 0;
+        for (int i = 0; i < 4; ++i) {
+            int low = THRESHOLD[i] - BUFF[i] * level;
+            int high = i == 3 ? 100 : THRESHOLD[i + 1] - BUFF[i + 1] * level;
+            raw += (high - low) * RATE[i];
+        }
+        matches = matches &&
+                  raised.expectedRate() == Quantity::fromRaw(raw / 100);
+    }
+    check("standard expected rates match the old table at levels 0 to 5 ("
+                  + raised.expectedRate().toString() + " at level 5)",
+          matches);
+
+    // a second formula reaching the same levels reuses what was built
+    std::shared_ptr<const TierTable> standard = TierTable::standard();
+    std::shared_ptr<const TierTable::Level> built = standard->at(3);
+    Formula other(oreCoal, oreCoalQty, oreCoalCnt, steel, steelQty, steelCnt);
+    for (int level = 0; level < 3; ++level)
+        other.increase();
+    check("increase reuses cached levels",
+          other.getTiers() == standard && standard->at(3) == built &&
+          other.expectedRate() == built->expected);
+
+    // a level where every weight is zero fails and changes nothing
+    Tier fadingTiers[] = {{1, 1, -1}};
+    Formula fading(ore, oreQty, oreCnt, bar, barQty, barCnt,
+                   std::make_shared<const TierTable>(fadingTiers, 1));
+    try {
+        fading.increase();
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    Inventory inventory;
+    inventory["iron ore"] = 2;
+    check("failed increase leaves the formula at level 0",
+          fading.getProficiency() == 0 && fading.expectedRate() == 1 &&
+          fading.craft(rng, inventory) && inventory["iron bar"] == 1);
+}
+
+void testAllocationReport() {
+    /*
+     * Description: Tests the AllocationTracker class.
+     * Input: None.
+     * Modify: Adds, copies, prints and simulates a Plan object.
+     * Output: Prints the allocations of each operation when the driver is
+     * built with -DPLAN_TRACK_ALLOCATIONS.
+     */
+    std::cout << "----------Test allocation report----------" << std::endl;
+    if (!AllocationTracker::enabled()) {
+        std::cout << "Allocation tracking is off." << std::endl;
+        return;
+    }
+
+    AllocationTracker::reset();
+
+    Plan plan;
+    for (int i = 0; i < 100; ++i)
+        plan.Add(&ironBar);
+    Plan copy(plan);
+    copy = plan;
+    std::string text = plan.toString();
+
+    Random rng(7);
+    Inventory inventory;
+    inventory["iron ore"] = 500;
+    inventory["iron bar"] = 0;
+    plan.simulate(rng, inventory);
+
+    AllocationTracker::report(std::cout);
+}
+
+void testOptimizer() {
+    /*
+     * Description: Tests the PlanOptimizer class.
+     * Input: None.
+     * Modify: Orders a plan whose own order stalls its first step, and
+     * reorders the plan by the best order found.
+     * Output: Prints whether the best order beat the plan's own order,
+     * scored what it leaves, and kept every step.
+     */
+    std::cout << "----------Test optimizer----------" << std::endl;
+
+    // the forge needs the bar that the smelter, listed after it, makes
+    Formula* sequences[] = {&forge, &smelter};
+    Plan plan(sequences, 2);
+    Inventory inventory;
+    inventory["iron ore"] = 2;
+
+    PlanOptimizer optimizer(plan, inventory);
+    Quantity stalled = optimizer.result({0, 1})["tool"];
+    Ordering best = optimizer.maximize("tool");
+
+    check("best order beats the plan's own order (" + best.score.toString()
+                  + " tool against " + stalled.toString() + ")",
+          best.finished && stalled == 0 && best.score > stalled);
+    check("best score is what its order leaves",
+          best.score == optimizer.result(best.order)["tool"]);
+
+    Plan reordered = PlanOptimizer::reorder(plan, best.order);
+    bool kept = reordered.getSize() == static_cast<int>(best.order.size());
+    for (int step = 0; step < plan.getSize(); ++step)
+        kept = kept && std::count(best.order.begin(), best.order.end(),
+                                  step) > 0;
+    for (int k = 0; k < reordered.getSize(); ++k)
+        kept = kept && reordered.getFormula(k).getCondition() ==
+                       plan.getFormula(best.order[k]).getCondition();
+    check("reorder keeps every step", kept);
+}
+
+void testCampaign() {
+    /*
+     * Description: Tests the CampaignSimulator class on a plan whose
+     * pattern takes 200 cycles to repeat and on a chain whose last step
+     * takes far longer.
+     * Input: None.
+     * Modify: Runs campaigns against cycle-by-cycle runs, and campaigns of
+     * a million and a trillion cycles.
+     * Output: Prints whether the campaigns matched the cycle-by-cycle runs
+     * and took about as long for either length.
+     */
+    std::cout << "----------Test campaign----------" << std::endl;
+
+    // runs every cycle of scenario at the plan's current rates
+    auto runCycles = [](const Plan& plan, const CampaignScenario& scenario) {
+        FlowModel model(plan);
+        FlowModel::Stock stock = model.stock(scenario.start);
+        const FlowModel::Stock supply = model.stock(scenario.supply);
+        for (long long cycle = 0; cycle < scenario.cycles; ++cycle) {
+            for (std::size_t i = 0; i < stock.size(); ++i)
+                stock[i] += supply[i];
+            for (int step = 0; step < plan.getSize(); ++step)
+                model.run(step, stock, plan.getFormula(step).expectedRate());
+        }
+        return model.inventory(stock);
+    };
+
+    // the forge crafts in 141 cycles of every 200 at the smelter's rate
+    Formula* sequences[] = {&quickSmelter, &forge};
+    Plan plan(sequences, 2);
+    CampaignSimulator simulator(plan);
+
+    CampaignScenario scenario;
+    scenario.supply["iron ore"] = 1;
+    scenario.cycles = 100000;
+    scenario.rules.maxLevel = 0;
+
+    Inventory expected = runCycles(plan, scenario);
+    Inventory inventory = simulator.run(scenario).inventory;
+    check("campaign matches a cycle-by-cycle run (" +
+                  inventory["tool"].toString() + " tool)",
+          inventory == expected);
+
+    // 2 ore -> 3 bar, 3 bar -> 3 plate, 2 plate -> 3 gear: each step
+    // crafts now and then at the rate of the one before
+    const std::string plate[] = {"iron plate"};
+    const std::string gear[] = {"gear"};
+    int twoQty[] = {2};
+    int threeQty[] = {3};
+    Formula barStep(ore, oreQty, oreCnt, bar, threeQty, barCnt);
+    Formula plateStep(bar, threeQty, barCnt, plate, threeQty, 1);
+    Formula gearStep(plate, twoQty, 1, gear, threeQty, 1);
+    Formula* chainSequences[] = {&barStep, &plateStep, &gearStep};
+    Plan chain(chainSequences, 3);
+
+    scenario.supply["iron ore"] = 2;
+    scenario.cycles = 200000;
+    expected = runCycles(chain, scenario);
+    inventory = CampaignSimulator(chain).run(scenario).inventory;
+    check("chain campaign matches a cycle-by-cycle run (" +
+                  inventory["gear"].toString() + " gear)",
+          inventory == expected);
+
+    // with level-ups, a trillion cycles take about as long as a million
+    scenario.supply["iron ore"] = 1;
+    scenario.rules = ExperienceRules();
+    scenario.cycles = 1000000;
+    auto started = std::chrono::steady_clock::now();
+    simulator.run(scenario);
+    auto shorter = std::chrono::steady_clock::now() - started;
+
+    scenario.cycles = 1000000000000LL;
+    started = std::chrono::steady_clock::now();
+    CampaignResult result = simulator.run(scenario);
+    auto longer = std::chrono::steady_clock::now() - started;
+
+    check("campaign time stays flat as cycles grow (level "
+                  + std::to_string(result.curves[1].back().level) + ", "
+                  + std::to_string(result.transitions) + " level-ups)",
+          longer < 4 * shorter + std::chrono::milliseconds(20));
+}
+
+void testSensitivity() {
+    /*
+     * Description: Tests the SensitivityAnalyzer class.
+     * Input: None.
+     * Modify: Ranks the steps of a plan by upgrade gain, and for each step
+     * upgrades it in a copy of the plan and runs the copy again.
+     * Output: Prints whether every ranked gain matched the change of the
+     * re-run.
+     */
+    std::cout << "----------Test sensitivity----------" << std::endl;
+
+    // the smelters share the ore, and the forge uses what they make
+    Formula* sequences[] = {&ironBar, &steelBar, &smelter, &forge, &forge};
+    Plan plan(sequences, 5);
+    Inventory inventory;
+    inventory["iron ore"] = 7;
+    inventory["coal"] = 1;
+
+    std::vector<int> order;
+    for (int step = 0; step < plan.getSize(); ++step)
+        order.push_back(step);
+
+    // the bar stock gains from the smelters, the tools from the forges
+    SensitivityAnalyzer analyzer(plan, inventory);
+    for (const std::string target : {"iron bar", "tool"}) {
+        Quantity before = PlanOptimizer(plan, inventory).result(order)[target];
+        std::vector<UpgradeGain> gains = analyzer.rank(target);
+
+        bool matches = analyzer.baseline(target) == before &&
+                       gains.size() == order.size();
+        for (const UpgradeGain& gain : gains) {
+            Plan copy(plan);
+            Formula upgraded(plan.getFormula(gain.step));
+            upgraded.increase();
+            copy.Replace(gain.step, &upgraded);
+
+            Quantity after =
+                    PlanOptimizer(copy, inventory).result(order)[target];
+            matches = matches && gain.gain == after - before;
+        }
+        check("ranked " + target + " gains match upgrading a copy and "
+                      "running it again (best step "
+                      + std::to_string(gains[0].step + 1) + ", "
+                      + gains[0].gain.toString() + ")",
+              matches && gains[0].gain > 0);
+    }
+}
+
 int main() {
     testPlanConstructor();
     testPlanAdd();
@@ -309,6 +1029,18 @@ int main() {
     testPlanCopyOperator();
     testPlanMoveOperator();
     testPlanException();
+    testQuantity();
+    testRatioSolver();
+    testCheckpoint();
+    testCatalogReload();
+    testServer();
+    testPlanExport();
+    testPlanBulk();
+    testTierTable();
+    testAllocationReport();
+    testOptimizer();
+    testCampaign();
+    testSensitivity();
 
     return 0;
 }
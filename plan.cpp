@@ -1,6 +1,10 @@
 #include "plan.h"
+#include "exporter.h"
+#include "allocation.h"
 #include <stdexcept>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 /// Author: Ai Sun
 ///   Date: 2023, Feb 2
@@ -8,6 +12,11 @@
 
 /// Revision History:
 /*      - 2024, Feb 1 Ai Sun - Initial creation of the class.
+ *      - 2026, Oct 19 - Add read accessors for the ratio solver.
+ *      - 2026, Oct 19 - Add simulate() and checkpoint access.
+ *      - 2026, Oct 19 - toString() streams through PlanExporter.
+ *      - 2026, Oct 19 - Add bulk operations and PlanView.
+ *      - 2026, Oct 19 - Add allocation tracking scopes.
  */
 
 /*
@@ -17,7 +26,10 @@
  * input materials into certain output materials.
  * The Plan class provides methods to add a new Formula to the plan, remove the
  * last Formula from the plan, and replace a
- * Formula at a specific index in the plan. It also provides methods to create a
+ * Formula at a specific index in the plan. Bulk methods reserve capacity,
+ * append, insert or erase a range of Formulas, and splice Formulas from one
+ * plan into another without copying them; PlanView gives read-only access
+ * to a range of steps without copying the plan. It also provides methods to create a
  * deep copy of a Plan object, move a Plan object,
  * and convert a Plan object to a string.
  *
@@ -38,8 +50,9 @@
  * std::invalid_argument exception if the initial size of the dynamic array is
  * negative, an std::underflow_error exception
  * if the Remove method is called when the dynamic array is empty, and an
- * std::out_of_range exception if the Replace method
- * is called with an invalid index.
+ * std::out_of_range exception if the Replace or getFormula method
+ * is called with an invalid index, or a range method with an invalid range,
+ * and an std::invalid_argument exception if a plan is spliced into itself.
  *
  * Assumptions:
  * The Plan class assumes that all Formula objects passed to its methods
@@ -74,6 +87,8 @@ Plan::Plan(Formula* initialSequences[], int initialSize)
 Plan::Plan(const Plan& source)
         : sequences(nullptr), size(DEFAULT), capacity(DEFAULT)
 {
+    ALLOCATION_SCOPE("Plan::copy");
+
     if (source.size > DEFAULT)
     {
         sequences = new Formula*[source.size];
@@ -86,7 +101,7 @@ Plan::Plan(const Plan& source)
 }
 
 // Move Constructor
-Plan::Plan(Plan&& source)
+Plan::Plan(Plan&& source) noexcept
         : sequences(source.sequences), size(source.size),
         capacity(source.capacity)
 {
@@ -98,6 +113,8 @@ Plan::Plan(Plan&& source)
 // Deep copy operator
 Plan& Plan::operator=(const Plan& source)
 {
+    ALLOCATION_SCOPE("Plan::operator=");
+
     if (this != &source)
     {
         // Release existing resources
@@ -106,6 +123,8 @@ Plan& Plan::operator=(const Plan& source)
             delete sequences[i];
         }
         delete[] sequences;
+        sequences = nullptr;
+        size = capacity = DEFAULT;
 
         // Copy from the source
         if (source.size > DEFAULT)
@@ -122,7 +141,7 @@ Plan& Plan::operator=(const Plan& source)
 }
 
 // Move operator
-Plan& Plan::operator=(Plan&& source)
+Plan& Plan::operator=(Plan&& source) noexcept
 {
     if (this != &source)
     {
@@ -160,6 +179,8 @@ Plan::~Plan()
 // Add function
 void Plan::Add(Formula* newFormula)
 {
+    ALLOCATION_SCOPE("Plan::Add");
+
     const int INITIAL = 1;
     const int DOUBLE = 2;
 
@@ -226,15 +247,234 @@ void Plan::Replace(int index, Formula* newFormula)
     sequences[index] = new Formula(*newFormula);
 }
 
+// Check range function
+void Plan::checkRange(int first, int last) const
+{
+    if (first < DEFAULT || first > last || last > size)
+    {
+        throw std::out_of_range("Range failed. Index out of range.");
+    }
+}
+
+// Open gap function
+Formula** Plan::openGap(int index, int count)
+{
+    const int DOUBLE = 2;
+
+    if (size + count > capacity)
+    {
+        Reserve(std::max(size + count, capacity * DOUBLE));
+    }
+
+    // Shift the tail once to make room
+    std::copy_backward(sequences + index, sequences + size,
+                       sequences + size + count);
+    size += count;
+
+    return sequences + index;
+}
+
+// Reserve function
+void Plan::Reserve(int newCapacity)
+{
+    if (newCapacity < DEFAULT)
+    {
+        throw std::invalid_argument("Reserve failed. Negative capacity.");
+    }
+
+    if (newCapacity <= capacity)
+        return;
+
+    // Only the pointers move; the formulas stay where they are
+    Formula** newArray = new Formula*[newCapacity];
+    std::copy(sequences, sequences + size, newArray);
+
+    delete[] sequences;
+    sequences = newArray;
+    capacity = newCapacity;
+}
+
+// Append function
+void Plan::Append(const PlanView& range)
+{
+    Insert(size, range);
+}
+
+// Insert function
+void Plan::Insert(int index, const PlanView& range)
+{
+    if (index < DEFAULT || index > size)
+    {
+        throw std::out_of_range("Insert failed. Index out of range.");
+    }
+
+    // Copy first, so a range viewing this plan stays valid
+    std::vector<Formula*> copies;
+    try
+    {
+        copies.reserve(range.getSize());
+        for (int i = DEFAULT; i < range.getSize(); ++i)
+        {
+            copies.push_back(new Formula(range.getFormula(i)));
+        }
+
+        Formula** gap = openGap(index, range.getSize());
+        std::copy(copies.begin(), copies.end(), gap);
+    }
+    catch (...)
+    {
+        for (Formula* copy : copies)
+        {
+            delete copy;
+        }
+        throw;
+    }
+}
+
+// Erase function
+void Plan::Erase(int first, int last)
+{
+    checkRange(first, last);
+
+    for (int i = first; i < last; ++i)
+    {
+        delete sequences[i];
+    }
+
+    std::copy(sequences + last, sequences + size, sequences + first);
+    size -= last - first;
+}
+
+// Splice function
+void Plan::Splice(int index, Plan& source, int first, int last)
+{
+    if (&source == this)
+    {
+        throw std::invalid_argument("Splice failed. Source is this plan.");
+    }
+    if (index < DEFAULT || index > size)
+    {
+        throw std::out_of_range("Splice failed. Index out of range.");
+    }
+    source.checkRange(first, last);
+
+    // Hand the formulas over, then close the hole in the source
+    Formula** gap = openGap(index, last - first);
+    std::copy(source.sequences + first, source.sequences + last, gap);
+
+    std::copy(source.sequences + last, source.sequences + source.size,
+              source.sequences + first);
+    source.size -= last - first;
+}
+
+// Get size function
+int Plan::getSize() const
+{
+    return size;
+}
+
+// Get formula function
+const Formula& Plan::getFormula(int index) const
+{
+    if (index < DEFAULT || index >= size)
+    {
+        throw std::out_of_range("Get failed. Index out of range.");
+    }
+
+    return *sequences[index];
+}
+
+// Get capacity function
+int Plan::getCapacity() const
+{
+    return capacity;
+}
+
+// View function
+PlanView Plan::view(int first, int last) const
+{
+    checkRange(first, last);
+
+    return PlanView(sequences + first, last - first);
+}
+
+// Simulate function
+int Plan::simulate(Random& rng, Inventory& inventory) const
+{
+    return PlanView(*this).simulate(rng, inventory);
+}
+
 // To string function
 std::string Plan::toString() {
+    ALLOCATION_SCOPE("Plan::toString");
+
     // each formula to string
     std::ostringstream os;
 
-    for (int i = DEFAULT; i < size; ++i)
     {
-        os << "(" << i + INDEX << ") " << sequences[i]->toString() << "\n";
+        PlanExporter exporter(os);
+        exporter.writePlan(*this);
     }
 
     return os.str();
+}
+
+// View constructor
+PlanView::PlanView(Formula* const* steps, int size)
+        : steps(steps), size(size)
+{
+    if (size < DEFAULT)
+    {
+        throw std::invalid_argument("View failed. Negative size.");
+    }
+}
+
+// View of a plan constructor
+PlanView::PlanView(const Plan& plan)
+        : steps(plan.sequences), size(plan.size)
+{
+}
+
+// View get size function
+int PlanView::getSize() const
+{
+    return size;
+}
+
+// View get formula function
+const Formula& PlanView::getFormula(int index) const
+{
+    if (index < DEFAULT || index >= size)
+    {
+        throw std::out_of_range("Get failed. Index out of range.");
+    }
+
+    return *steps[index];
+}
+
+// View slice function
+PlanView PlanView::slice(int first, int last) const
+{
+    if (first < DEFAULT || first > last || last > size)
+    {
+        throw std::out_of_range("Slice failed. Index out of range.");
+    }
+
+    return PlanView(steps + first, last - first);
+}
+
+// View simulate function
+int PlanView::simulate(Random& rng, Inventory& inventory) const
+{
+    ALLOCATION_SCOPE("Plan::simulate");
+
+    int crafted = DEFAULT;
+
+    for (int i = DEFAULT; i < size; ++i)
+    {
+        if (steps[i]->craft(rng, inventory))
+            ++crafted;
+    }
+
+    return crafted;
 }
\ No newline at end of file
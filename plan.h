@@ -9,8 +9,72 @@
 
 /// Revision History:
 /*      - 2024, Feb 1 Ai Sun - Initial creation of the class.
+ *      - 2026, Oct 19 - Add read accessors for the ratio solver.
+ *      - 2026, Oct 19 - Add simulate() and checkpoint access.
+ *      - 2026, Oct 19 - Add bulk operations and PlanView.
  */
 
+class Plan;
+
+/// <summary>
+/// Class representing a non-owning view of consecutive steps of a plan.
+/// A view is two words and copying it never copies a Formula, so functions
+/// that only read steps take a PlanView, and a Plan converts to one
+/// implicitly.
+/// Class Invariant: The viewed steps stay valid while the view is used; any
+/// change to the size or capacity of the viewed Plan invalidates the view.
+/// </summary>
+class PlanView
+{
+private:
+    Formula* const* steps;  // first step viewed
+    int size;               // number of steps viewed
+    static const int DEFAULT = 0;
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: steps must hold size valid Formula pointers.
+    /// Postcondition: A view of the size steps is created.
+    /// </summary>
+    PlanView(Formula* const* steps = nullptr, int size = DEFAULT);
+
+    /// <summary>
+    /// Plan Constructor
+    /// Precondition: None.
+    /// Postcondition: A view of every step of plan is created.
+    /// </summary>
+    PlanView(const Plan& plan);
+
+    /// <summary>
+    /// Get Size function
+    /// Precondition: None.
+    /// Postcondition: The number of steps viewed is returned.
+    /// </summary>
+    int getSize() const;
+
+    /// <summary>
+    /// Get Formula function
+    /// Precondition: index must be a valid index in the view.
+    /// Postcondition: The Formula object at index is returned.
+    /// </summary>
+    const Formula& getFormula(int index) const;
+
+    /// <summary>
+    /// Slice function
+    /// Precondition: 0 <= first <= last <= size.
+    /// Postcondition: A view of the steps [first, last) is returned.
+    /// </summary>
+    PlanView slice(int first, int last) const;
+
+    /// <summary>
+    /// Simulate function
+    /// Precondition: None.
+    /// Postcondition: Same as Plan::simulate over the viewed steps.
+    /// </summary>
+    int simulate(Random& rng, Inventory& inventory) const;
+};
+
 /// <summary>
 /// Class representing a plan.
 /// Class Invariant: The size of the dynamic array must always be non-negative,
@@ -26,6 +90,15 @@ private:
     static const int DEFAULT = 0; // default value
     const int INDEX = 1;          // default index
 
+    friend class Checkpoint;
+    friend class PlanView;
+
+    // throws std::out_of_range unless 0 <= first <= last <= size
+    void checkRange(int first, int last) const;
+
+    // opens a gap of count slots at index and returns its start
+    Formula** openGap(int index, int count);
+
 public:
     /// <summary>
     /// Default Constructor
@@ -46,7 +119,7 @@ public:
     /// Precondition: The source Plan object must be valid.
     /// Postcondition: The source Plan object is moved into the new Plan object.
     /// </summary>
-    Plan(Plan&& source);
+    Plan(Plan&& source) noexcept;
 
     /// <summary>
     /// Deep copy operator
@@ -61,7 +134,7 @@ public:
     /// Postcondition: The source Plan object is moved into the current Plan
     /// object. The source Plan object is empty.
     /// </summary>
-    Plan& operator=(Plan&& source);
+    Plan& operator=(Plan&& source) noexcept;
 
     /// <summary>
     /// Deconstructor
@@ -93,6 +166,87 @@ public:
     /// </summary>
     void Replace(int index, Formula* newFormula);
 
+    /// <summary>
+    /// Reserve function
+    /// Precondition: newCapacity must be non-negative.
+    /// Postcondition: The capacity is at least newCapacity, so that many
+    /// Formula objects can be added without reallocating. No Formula object
+    /// is copied.
+    /// </summary>
+    void Reserve(int newCapacity);
+
+    /// <summary>
+    /// Append function
+    /// Precondition: None.
+    /// Postcondition: Copies of the Formula objects in range are added at
+    /// the end of the Plan, reallocating at most once. range may view this
+    /// Plan.
+    /// </summary>
+    void Append(const PlanView& range);
+
+    /// <summary>
+    /// Insert function
+    /// Precondition: index must be in [0, size].
+    /// Postcondition: Copies of the Formula objects in range are inserted
+    /// before index. range may view this Plan.
+    /// </summary>
+    void Insert(int index, const PlanView& range);
+
+    /// <summary>
+    /// Erase function
+    /// Precondition: 0 <= first <= last <= size.
+    /// Postcondition: The Formula objects at [first, last) are removed.
+    /// </summary>
+    void Erase(int first, int last);
+
+    /// <summary>
+    /// Splice function
+    /// Precondition: index must be in [0, size], 0 <= first <= last <= the
+    /// size of source, and source must not be this Plan.
+    /// Postcondition: The Formula objects at [first, last) of source are
+    /// moved, without copying, before index of this Plan and removed from
+    /// source.
+    /// </summary>
+    void Splice(int index, Plan& source, int first, int last);
+
+    /// <summary>
+    /// Get Size function
+    /// Precondition: None.
+    /// Postcondition: The number of Formula objects in the Plan is returned.
+    /// </summary>
+    int getSize() const;
+
+    /// <summary>
+    /// Get Formula function
+    /// Precondition: index must be a valid index in the Plan object.
+    /// Postcondition: The Formula object at index is returned.
+    /// </summary>
+    const Formula& getFormula(int index) const;
+
+    /// <summary>
+    /// Get Capacity function
+    /// Precondition: None.
+    /// Postcondition: The capacity of the dynamic array is returned.
+    /// </summary>
+    int getCapacity() const;
+
+    /// <summary>
+    /// View function
+    /// Precondition: 0 <= first <= last <= size.
+    /// Postcondition: A view of the Formula objects at [first, last) is
+    /// returned.
+    /// </summary>
+    PlanView view(int first, int last) const;
+
+    /// <summary>
+    /// Simulate function
+    /// Precondition: None.
+    /// Postcondition: Each Formula is crafted once, in order, against
+    /// inventory with produce rates drawn from rng; a step whose inputs are
+    /// missing is skipped. The number of steps crafted is returned.
+    /// </summary>
+    int simulate(Random& rng, Inventory& inventory) const;
+
     /// <summary>
     /// To String function
     /// Precondition: None.
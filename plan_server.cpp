@@ -0,0 +1,138 @@
+#include <iostream>
+#include <csignal>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "catalog.h"
+#include "server.h"
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the daemon.
+ */
+
+/*
+ * Purpose: This program is the local simulation daemon. It holds one formula
+ * catalog in memory and serves it to every tool on the host over a Unix
+ * domain socket, so tools no longer each embed their own copy.
+ * Input: argv[1] is the socket path and argv[2] a checkpoint file whose
+ * first plan is the catalog. Sending SIGHUP reloads the catalog from that
+ * file without interrupting requests; SIGINT or SIGTERM stops the daemon.
+ * Process: The SimulationServer event loop answers simulate, expected-yield
+ * and bill-of-materials requests in batches. A reload is parsed and solved
+ * on a thread of its own, so the event loop keeps answering with the old
+ * snapshot until the catalog swaps in the new one.
+ * Output: Errors are printed to standard error.
+ */
+
+namespace
+{
+    volatile std::sig_atomic_t reloadRequested = 0;
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void onReload(int)
+    {
+        reloadRequested = 1;
+    }
+
+    void onStop(int)
+    {
+        stopRequested = 1;
+    }
+
+    // reloads a catalog from its file on a thread of its own; requests made
+    // while a reload runs are folded into one more reload
+    class Reloader
+    {
+    private:
+        Catalog& catalog;
+        std::string file;
+        std::mutex waiting;
+        std::condition_variable requested;
+        bool pending, closing;
+        std::thread thread;
+
+        void work()
+        {
+            std::unique_lock<std::mutex> lock(waiting);
+            while (true)
+            {
+                requested.wait(lock, [this]() { return pending || closing; });
+                if (closing)
+                    return;
+
+                pending = false;
+                lock.unlock();
+                try {
+                    catalog.reloadFile(file);
+                } catch (std::exception& e) {
+                    std::cerr << "Reload failed: " << e.what() << std::endl;
+                }
+                lock.lock();
+            }
+        }
+
+    public:
+        Reloader(Catalog& catalog, const std::string& file)
+                : catalog(catalog), file(file), pending(false), closing(false),
+                  thread(&Reloader::work, this)
+        {
+        }
+
+        ~Reloader()
+        {
+            {
+                std::lock_guard<std::mutex> lock(waiting);
+                closing = true;
+            }
+            requested.notify_one();
+            thread.join();
+        }
+
+        void request()
+        {
+            {
+                std::lock_guard<std::mutex> lock(waiting);
+                pending = true;
+            }
+            requested.notify_one();
+        }
+    };
+}
+
+int main(int argc, char* argv[]) {
+    const int ARGUMENTS = 3, POLL_MS = 100;
+
+    if (argc != ARGUMENTS) {
+        std::cerr << "usage: " << argv[0] << " <socket> <catalog checkpoint>"
+                  << std::endl;
+        return 1;
+    }
+
+    try {
+        Catalog catalog;
+        catalog.reloadFile(argv[2]);
+
+        Reloader reloader(catalog, argv[2]);
+        SimulationServer server(catalog, argv[1]);
+
+        std::signal(SIGHUP, onReload);
+        std::signal(SIGINT, onStop);
+        std::signal(SIGTERM, onStop);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        while (!stopRequested) {
+            server.serveOnce(POLL_MS);
+
+            if (reloadRequested) {
+                reloadRequested = 0;
+                reloader.request();
+            }
+        }
+    } catch (std::exception& e) {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
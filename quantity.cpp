@@ -0,0 +1,234 @@
+// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ *      - 2026, Oct 19 - Add toChars() for allocation-free output.
+ */
+
+/*
+ * This is the implementation of quantity.h. The Quantity class represents a
+ * material quantity as a fixed-point number with four decimal places, so
+ * that produce rates, simulated outputs and inventory totals add up exactly
+ * no matter how many crafts are accumulated.
+ *
+ * Implementation Invariant:
+ * The value is kept as a signed 64-bit count of 1 / SCALE units. Sums and
+ * differences are exact. Products and quotients are computed in 128 bits and
+ * rounded once to the nearest raw unit, half away from zero, so results are
+ * deterministic on every platform.
+ *
+ * Error Processing:
+ * Every operation checks for overflow and throws an std::overflow_error
+ * instead of wrapping. Division by zero throws an std::domain_error.
+ *
+ * Assumptions:
+ * The compiler provides __int128 and the __builtin_*_overflow intrinsics
+ * (GCC and Clang).
+ */
+
+#include "quantity.h"
+#include <stdexcept>
+#include <climits>
+#include <string>
+#include <algorithm>
+
+namespace
+{
+    // checks that a 128-bit intermediate fits back into a raw value
+    long long narrow(__int128 value)
+    {
+        if (value > LLONG_MAX || value < LLONG_MIN)
+            throw std::overflow_error("quantity overflow.");
+
+        return static_cast<long long>(value);
+    }
+
+    // divides by a positive denominator and rounds to the nearest integer,
+    // half away from zero
+    __int128 divideRounded(__int128 numerator, __int128 denominator)
+    {
+        __int128 quotient = numerator / denominator;
+        __int128 remainder = numerator % denominator;
+
+        if (remainder < 0)
+            remainder = -remainder;
+
+        if (remainder * 2 >= denominator)
+            quotient += (numerator < 0) ? -1 : 1;
+
+        return quotient;
+    }
+}
+
+Quantity::Quantity(long long whole)
+{
+    if (__builtin_mul_overflow(whole, SCALE, &value))
+        throw std::overflow_error("quantity overflow.");
+}
+
+Quantity Quantity::fromRaw(long long raw)
+{
+    Quantity quantity;
+    quantity.value = raw;
+    return quantity;
+}
+
+Quantity Quantity::ratio(long long numerator, long long denominator)
+{
+    if (denominator == 0)
+        throw std::domain_error("quantity ratio denominator is zero.");
+
+    // keep the sign on the numerator so rounding sees a positive divisor
+    __int128 top = static_cast<__int128>(numerator) * SCALE;
+    __int128 bottom = denominator;
+    if (bottom < 0) {
+        top = -top;
+        bottom = -bottom;
+    }
+
+    return fromRaw(narrow(divideRounded(top, bottom)));
+}
+
+long long Quantity::getRaw() const
+{
+    return value;
+}
+
+double Quantity::toDouble() const
+{
+    return static_cast<double>(value) / SCALE;
+}
+
+Quantity Quantity::operator+(const Quantity& other) const
+{
+    long long sum;
+    if (__builtin_add_overflow(value, other.value, &sum))
+        throw std::overflow_error("quantity overflow.");
+
+    return fromRaw(sum);
+}
+
+Quantity Quantity::operator-(const Quantity& other) const
+{
+    long long difference;
+    if (__builtin_sub_overflow(value, other.value, &difference))
+        throw std::overflow_error("quantity overflow.");
+
+    return fromRaw(difference);
+}
+
+Quantity Quantity::operator*(const Quantity& other) const
+{
+    __int128 product = static_cast<__int128>(value) * other.value;
+
+    return fromRaw(narrow(divideRounded(product, SCALE)));
+}
+
+Quantity Quantity::operator/(const Quantity& other) const
+{
+    if (other.value == 0)
+        throw std::domain_error("quantity division by zero.");
+
+    __int128 top = static_cast<__int128>(value) * SCALE;
+    __int128 bottom = other.value;
+    if (bottom < 0) {
+        top = -top;
+        bottom = -bottom;
+    }
+
+    return fromRaw(narrow(divideRounded(top, bottom)));
+}
+
+Quantity Quantity::operator-() const
+{
+    return Quantity() - *this;
+}
+
+Quantity& Quantity::operator+=(const Quantity& other)
+{
+    *this = *this + other;
+    return *this;
+}
+
+Quantity& Quantity::operator-=(const Quantity& other)
+{
+    *this = *this - other;
+    return *this;
+}
+
+Quantity& Quantity::operator*=(const Quantity& other)
+{
+    *this = *this * other;
+    return *this;
+}
+
+bool Quantity::operator==(const Quantity& other) const
+{
+    return value == other.value;
+}
+
+bool Quantity::operator!=(const Quantity& other) const
+{
+    return value != other.value;
+}
+
+bool Quantity::operator<(const Quantity& other) const
+{
+    return value < other.value;
+}
+
+bool Quantity::operator<=(const Quantity& other) const
+{
+    return value <= other.value;
+}
+
+bool Quantity::operator>(const Quantity& other) const
+{
+    return value > other.value;
+}
+
+bool Quantity::operator>=(const Quantity& other) const
+{
+    return value >= other.value;
+}
+
+std::string Quantity::toString() const
+{
+    char text[MAX_CHARS];
+    return std::string(text, toChars(text));
+}
+
+int Quantity::toChars(char* out) const
+{
+    // work on the magnitude so LLONG_MIN does not overflow
+    unsigned long long magnitude = value < 0
+            ? 0ULL - static_cast<unsigned long long>(value)
+            : static_cast<unsigned long long>(value);
+    unsigned long long whole = magnitude / SCALE;
+    unsigned long long fraction = magnitude % SCALE;
+
+    char* end = out;
+    if (value < 0)
+        *end++ = '-';
+
+    // whole digits, written backwards then reversed
+    char* first = end;
+    do {
+        *end++ = static_cast<char>('0' + whole % 10);
+        whole /= 10;
+    } while (whole != 0);
+    std::reverse(first, end);
+
+    if (fraction != 0) {
+        *end++ = '.';
+        for (unsigned long long unit = SCALE / 10; fraction != 0; unit /= 10) {
+            *end++ = static_cast<char>('0' + fraction / unit);
+            fraction %= unit;
+        }
+    }
+
+    return static_cast<int>(end - out);
+}
+
+std::ostream& operator<<(std::ostream& os, const Quantity& quantity)
+{
+    return os << quantity.toString();
+}
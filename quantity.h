@@ -0,0 +1,135 @@
+#ifndef QUANTITY_H
+#define QUANTITY_H
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ *      - 2026, Oct 19 - Add toChars() for allocation-free output.
+ */
+
+#include<string>
+#include<map>
+#include<ostream>
+#include<type_traits>
+
+/// <summary>
+/// Class representing an exact fixed-point material quantity.
+/// The value is stored as a 64-bit integer count of 1 / SCALE units, so
+/// produce rates such as 0.75 or 1.1 and every output and inventory total
+/// derived from them are represented exactly.
+/// Class Invariant: Every arithmetic result fits in 64 bits; an operation
+/// that would overflow throws instead of wrapping.
+/// </summary>
+class Quantity
+{
+private:
+    // raw value in units of 1 / SCALE
+    long long value;
+
+public:
+    // number of raw units in one whole unit (four decimal places)
+    static const long long SCALE = 10000;
+
+    // longest text toChars() writes (sign, 15 digits, point, 4 digits)
+    static const int MAX_CHARS = 24;
+
+    /// <summary>
+    /// Constructor
+    /// Precondition: whole * SCALE must fit in 64 bits.
+    /// Postcondition: A Quantity holding the given whole number is created.
+    /// </summary>
+    Quantity(long long whole = 0);
+
+    /// <summary>
+    /// Floating-point constructor (deleted)
+    /// A double would be truncated to a whole number, so 0.75 would become
+    /// 0. Use ratio() or fromRaw() for fractional quantities.
+    /// </summary>
+    template<typename T, typename = typename std::enable_if
+            <std::is_floating_point<T>::value>::type>
+    Quantity(T) = delete;
+
+    /// <summary>
+    /// From Raw function
+    /// Precondition: None.
+    /// Postcondition: A Quantity holding raw / SCALE is returned.
+    /// </summary>
+    static Quantity fromRaw(long long raw);
+
+    /// <summary>
+    /// Ratio function
+    /// Precondition: denominator must not be zero.
+    /// Postcondition: numerator / denominator rounded to the nearest raw
+    /// unit (half away from zero) is returned.
+    /// </summary>
+    static Quantity ratio(long long numerator, long long denominator);
+
+    /// <summary>
+    /// Get Raw function
+    /// Precondition: None.
+    /// Postcondition: The raw value in units of 1 / SCALE is returned.
+    /// </summary>
+    long long getRaw() const;
+
+    /// <summary>
+    /// To Double function
+    /// Precondition: None.
+    /// Postcondition: The nearest double to the quantity is returned.
+    /// </summary>
+    double toDouble() const;
+
+    /// <summary>
+    /// Arithmetic operators
+    /// Precondition: The result must fit in 64 bits, and a divisor must not
+    /// be zero.
+    /// Postcondition: The exact sum or difference is returned; products and
+    /// quotients are rounded to the nearest raw unit (half away from zero).
+    /// </summary>
+    Quantity operator+(const Quantity& other) const;
+    Quantity operator-(const Quantity& other) const;
+    Quantity operator*(const Quantity& other) const;
+    Quantity operator/(const Quantity& other) const;
+    Quantity operator-() const;
+    Quantity& operator+=(const Quantity& other);
+    Quantity& operator-=(const Quantity& other);
+    Quantity& operator*=(const Quantity& other);
+
+    /// <summary>
+    /// Comparison operators
+    /// Precondition: None.
+    /// Postcondition: The raw values are compared.
+    /// </summary>
+    bool operator==(const Quantity& other) const;
+    bool operator!=(const Quantity& other) const;
+    bool operator<(const Quantity& other) const;
+    bool operator<=(const Quantity& other) const;
+    bool operator>(const Quantity& other) const;
+    bool operator>=(const Quantity& other) const;
+
+    /// <summary>
+    /// To String function
+    /// Precondition: None.
+    /// Postcondition: A decimal representation without trailing zeros is
+    /// returned, for example "749.25" or "999".
+    /// </summary>
+    std::string toString() const;
+
+    /// <summary>
+    /// To Chars function
+    /// Precondition: out must have room for MAX_CHARS characters.
+    /// Postcondition: The toString() text is written to out without
+    /// allocating, and its length is returned. No terminator is written.
+    /// </summary>
+    int toChars(char* out) const;
+};
+
+/// <summary>
+/// Output operator
+/// Precondition: None.
+/// Postcondition: The decimal representation of quantity is written to os.
+/// </summary>
+std::ostream& operator<<(std::ostream& os, const Quantity& quantity);
+
+// holds material names and their total quantities
+typedef std::map<std::string, Quantity> Inventory;
+
+#endif // !QUANTITY_H
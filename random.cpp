@@ -0,0 +1,68 @@
+// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/*
+ * This is the implementation of random.h. The Random class is a small
+ * xoshiro256** generator whose state is four 64-bit words seeded through
+ * splitmix64.
+ *
+ * Implementation Invariant:
+ * The four state words are never all zero, which splitmix64 seeding
+ * guarantees. The sequence depends only on the state, so saving and
+ * restoring the state continues the sequence bit for bit.
+ *
+ * Error Processing:
+ * nextInt throws an std::invalid_argument exception if bound isn't positive.
+ *
+ * Assumptions:
+ * None.
+ */
+
+#include "random.h"
+#include <stdexcept>
+
+namespace
+{
+    // rotates x left by k bits
+    unsigned long long rotate(unsigned long long x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+}
+
+Random::Random(unsigned long long seed)
+{
+    // splitmix64 spreads the seed over the state
+    for (int i = DEFAULT; i < WORDS; ++i) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        unsigned long long z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+unsigned long long Random::next()
+{
+    const unsigned long long result = rotate(state[1] * 5, 7) * 9;
+    const unsigned long long shifted = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3] = rotate(state[3], 45);
+
+    return result;
+}
+
+int Random::nextInt(int bound)
+{
+    if (bound <= DEFAULT)
+        throw std::invalid_argument("bound should be positive.");
+
+    // scale the high 32 bits onto [0, bound)
+    return static_cast<int>(((next() >> 32) * bound) >> 32);
+}
@@ -0,0 +1,53 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/// <summary>
+/// Class representing a seedable random number stream (xoshiro256**).
+/// Unlike rand(), every stream owns its whole state, so simulations can run
+/// independent streams side by side and a checkpoint can save and restore a
+/// stream exactly.
+/// Class Invariant: The state is never all zero.
+/// </summary>
+class Random
+{
+private:
+    // numbers of state words
+    static const int WORDS = 4;
+
+    // holds the generator state
+    unsigned long long state[WORDS];
+
+    // default value
+    static const int DEFAULT = 0;
+
+    friend class Checkpoint;
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: None.
+    /// Postcondition: A stream whose state is derived from seed is created;
+    /// equal seeds give equal sequences.
+    /// </summary>
+    explicit Random(unsigned long long seed = DEFAULT);
+
+    /// <summary>
+    /// Next function
+    /// Precondition: None.
+    /// Postcondition: The next 64-bit number of the stream is returned.
+    /// </summary>
+    unsigned long long next();
+
+    /// <summary>
+    /// Next Int function
+    /// Precondition: bound must be positive.
+    /// Postcondition: A number in the range [0, bound) is returned.
+    /// </summary>
+    int nextInt(int bound);
+};
+
+#endif // !RANDOM_H
@@ -0,0 +1,308 @@
+#include "sensitivity.h"
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <utility>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/*
+ * This is the implementation of sensitivity.h. SensitivityAnalyzer ranks
+ * the steps of a plan by how much one more proficiency level of their
+ * formula would add to a target material.
+ *
+ * Implementation Invariant:
+ * An evaluation keeps diff, the stock of the upgraded run minus the stock
+ * of the baseline run at the same point. Before the upgraded step diff is
+ * empty; a step that crafted in the baseline adds its extra output at the
+ * higher rate. A later step sees its noted baseline stock plus diff, so its
+ * check can only change if it consumes a material with a non-zero diff. If
+ * the check gives the same answer, the step changes both runs alike and
+ * diff stays; if it flips, the step's inputs and outputs go into diff. The
+ * steps to look at are found through consumers: a queue holds, for every
+ * material with a non-zero diff, its next consumer after the current step.
+ * When more than SPARSE materials are queued the queue is dropped and the
+ * remaining steps are walked in order, skipping those that consume no
+ * material with a diff. The target's diff at the end is the gain. Scratch
+ * memory is dense per thread and only the touched entries are cleared
+ * between evaluations.
+ *
+ * Error Processing:
+ * baseline, gain and rank throw an std::invalid_argument exception for a
+ * target no step uses, and gain an std::out_of_range exception for a bad
+ * step. The constructor passes on the std::domain_error of TierTable::at
+ * for a formula that can't rise a level.
+ *
+ * Assumptions:
+ * Produce rates are those of FlowModel, and one level up those of the
+ * formula's TierTable.
+ */
+
+namespace
+{
+    // candidates a thread takes at a time
+    const int CHUNK = 64;
+
+    // queued materials above which the remaining steps are walked instead
+    const std::size_t SPARSE = 16;
+}
+
+// working memory of one evaluation
+struct SensitivityAnalyzer::Scratch
+{
+    // (step, material): the next consumer of a material with a diff
+    typedef std::pair<int, int> Visit;
+    typedef std::priority_queue<Visit, std::vector<Visit>,
+                                std::greater<Visit>> Queue;
+
+    std::vector<long long> diff;
+    std::vector<int> touched;
+    Queue queue;
+
+    explicit Scratch(int items)
+            : diff(items, 0)
+    {
+    }
+};
+
+// Constructor
+SensitivityAnalyzer::SensitivityAnalyzer(const PlanView& plan,
+                                         const Inventory& inventory)
+        : model(plan), consumers(model.getItemCount())
+{
+    const int steps = model.getSize();
+
+    upgraded.reserve(steps);
+    for (int s = 0; s < steps; ++s)
+    {
+        const Formula& formula = plan.getFormula(s);
+        upgraded.push_back
+                (formula.getTiers()->at(formula.getProficiency() + 1)->expected);
+    }
+
+    first.assign(steps + 1, 0);
+    for (int s = 0; s < steps; ++s)
+    {
+        for (const FlowModel::Entry& input : model.getInputs(s))
+            consumers[input.item].push_back(s);
+        first[s + 1] = first[s] + static_cast<int>(model.getInputs(s).size());
+    }
+
+    // the baseline run, noting what every check saw
+    finish = model.stock(inventory);
+    seen.resize(first[steps]);
+    crafted.resize(steps);
+    for (int s = 0; s < steps; ++s)
+    {
+        const std::vector<FlowModel::Entry>& inputs = model.getInputs(s);
+        for (std::size_t k = 0; k < inputs.size(); ++k)
+            seen[first[s] + k] = finish[inputs[k].item];
+
+        crafted[s] = model.run(s, finish);
+    }
+}
+
+// Target of function
+int SensitivityAnalyzer::targetOf(const std::string& target) const
+{
+    const int item = model.find(target);
+    if (item == FlowModel::NONE)
+        throw std::invalid_argument("No step uses the target " + target + ".");
+
+    return item;
+}
+
+// Evaluate function
+long long SensitivityAnalyzer::evaluate(int step, int target,
+                                        Scratch& scratch) const
+{
+    if (!crafted[step])
+        return 0;
+
+    bool scanning = false;      // every later step is looked at in turn
+    int live = 0;               // materials with a non-zero diff
+
+    // adds amount to the diff of item, queueing its next consumer after
+    // current when the diff becomes non-zero
+    auto add = [&](int item, long long amount, int current)
+    {
+        if (amount == 0)
+            return;
+
+        if (scratch.diff[item] == 0)
+        {
+            live++;
+            const std::vector<int>& users = consumers[item];
+            auto next = std::upper_bound(users.begin(), users.end(), current);
+            if (!scanning && next != users.end())
+                scratch.queue.emplace(*next, item);
+        }
+        scratch.diff[item] += amount;
+        if (scratch.diff[item] == 0)
+            live--;
+        scratch.touched.push_back(item);
+    };
+
+    // flips step s if its check now gives the other answer
+    auto check = [&](int s)
+    {
+        const std::vector<FlowModel::Entry>& inputs = model.getInputs(s);
+        bool runs = true;
+        for (std::size_t k = 0; k < inputs.size() && runs; ++k)
+            runs = seen[first[s] + k] + scratch.diff[inputs[k].item] >=
+                   inputs[k].amount;
+
+        if (runs == static_cast<bool>(crafted[s]))
+            return;
+
+        // the step now runs in only one of the two
+        const long long sign = runs ? 1 : -1;
+        for (const FlowModel::Entry& input : inputs)
+            add(input.item, -sign * input.amount, s);
+        for (const FlowModel::Entry& output : model.getOutputs(s))
+            add(output.item, sign * output.amount, s);
+    };
+
+    const std::vector<FlowModel::Entry>& results = model.getResults(step);
+    const std::vector<FlowModel::Entry>& outputs = model.getOutputs(step);
+    for (std::size_t k = 0; k < results.size(); ++k)
+    {
+        const long long more =
+                (upgraded[step] * Quantity::fromRaw(results[k].amount))
+                        .getRaw();
+        add(results[k].item, more - outputs[k].amount, step);
+    }
+
+    int last = step;
+    while (!scratch.queue.empty() && scratch.queue.size() <= SPARSE)
+    {
+        const Scratch::Visit visit = scratch.queue.top();
+        scratch.queue.pop();
+
+        const int s = visit.first;
+        const int item = visit.second;
+        if (scratch.diff[item] == 0)
+            continue;
+
+        // the material keeps its diff past s, so queue its next consumer
+        const std::vector<int>& users = consumers[item];
+        auto next = std::upper_bound(users.begin(), users.end(), s);
+        if (next != users.end())
+            scratch.queue.emplace(*next, item);
+
+        if (s <= last)
+            continue;
+        last = s;
+        check(s);
+    }
+
+    // once the diff has spread, walking the steps is cheaper than the queue
+    if (!scratch.queue.empty())
+    {
+        scanning = true;
+        scratch.queue = Scratch::Queue();
+
+        for (int s = last + 1; s < model.getSize() && live > 0; ++s)
+        {
+            for (const FlowModel::Entry& input : model.getInputs(s))
+            {
+                if (scratch.diff[input.item] != 0)
+                {
+                    check(s);
+                    break;
+                }
+            }
+        }
+    }
+
+    const long long change = scratch.diff[target];
+
+    for (int item : scratch.touched)
+        scratch.diff[item] = 0;
+    scratch.touched.clear();
+
+    return change;
+}
+
+// Baseline function
+Quantity SensitivityAnalyzer::baseline(const std::string& target) const
+{
+    return Quantity::fromRaw(finish[targetOf(target)]);
+}
+
+// Gain function
+Quantity SensitivityAnalyzer::gain(int step, const std::string& target) const
+{
+    const int item = targetOf(target);
+    if (step < 0 || step >= model.getSize())
+        throw std::out_of_range("Gain failed. Step out of range.");
+
+    Scratch scratch(model.getItemCount());
+
+    return Quantity::fromRaw(evaluate(step, item, scratch));
+}
+
+// Rank function
+std::vector<UpgradeGain> SensitivityAnalyzer::rank(const std::string& target,
+                                                   int threads) const
+{
+    const int item = targetOf(target);
+    if (threads < 0)
+        throw std::invalid_argument("threads should be non-negative.");
+
+    const int steps = model.getSize();
+    std::vector<UpgradeGain> gains(steps);
+
+    std::size_t workers = threads > 0 ? threads :
+            std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min<std::size_t>(workers, steps / CHUNK + 1);
+
+    // candidates differ in cost, so threads take the next chunk when free
+    std::atomic<int> next(0);
+    std::exception_ptr failure;
+    std::atomic<bool> failed(false);
+    auto work = [&]()
+    {
+        try
+        {
+            Scratch scratch(model.getItemCount());
+            for (int begin = next.fetch_add(CHUNK);
+                 begin < steps && !failed; begin = next.fetch_add(CHUNK))
+            {
+                const int end = std::min(steps, begin + CHUNK);
+                for (int s = begin; s < end; ++s)
+                    gains[s] = UpgradeGain{ s, Quantity::fromRaw
+                            (evaluate(s, item, scratch)) };
+            }
+        }
+        catch (...)
+        {
+            if (!failed.exchange(true))
+                failure = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t w = 1; w < workers; ++w)
+        pool.emplace_back(work);
+    work();
+    for (std::thread& thread : pool)
+        thread.join();
+
+    if (failure)
+        std::rethrow_exception(failure);
+
+    std::sort(gains.begin(), gains.end(),
+              [](const UpgradeGain& a, const UpgradeGain& b)
+              {
+                  return a.gain != b.gain ? a.gain > b.gain : a.step < b.step;
+              });
+
+    return gains;
+}
@@ -0,0 +1,98 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include "flow.h"
+#include "plan.h"
+#include "quantity.h"
+#include <string>
+#include <vector>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/// <summary>
+/// Gain in target output from raising the formula of one step by one
+/// proficiency level.
+/// </summary>
+struct UpgradeGain
+{
+    int step;
+    Quantity gain;
+};
+
+/// <summary>
+/// Class representing an upgrade sensitivity analysis of a Plan.
+/// The plan is run once from a start inventory with expected produce rates
+/// (see FlowModel), noting what stock every step saw. The effect of
+/// upgrading one step is then worked out as a difference from that run: it
+/// starts at the step's extra output and is carried only to later steps
+/// that consume a material whose stock differs, so each candidate costs the
+/// steps it actually affects instead of a full run of a copied plan.
+/// Class Invariant: The model, upgraded rates and noted run match the plan
+/// and inventory the analyzer was built from.
+/// </summary>
+class SensitivityAnalyzer
+{
+private:
+    // working memory of one evaluation
+    struct Scratch;
+
+    FlowModel model;
+
+    // holds the expected produce rate of each step one level up
+    std::vector<Quantity> upgraded;
+
+    // holds the steps consuming each material, in plan order
+    std::vector<std::vector<int>> consumers;
+
+    // the baseline run: stock each input saw (from first[s] on for step s),
+    // which steps crafted, and the stock at the end
+    std::vector<int> first;
+    std::vector<long long> seen;
+    std::vector<char> crafted;
+    FlowModel::Stock finish;
+
+    // returns the change of target stock when step is upgraded
+    long long evaluate(int step, int target, Scratch& scratch) const;
+
+    // returns the id of target, checking that a step uses it
+    int targetOf(const std::string& target) const;
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: The formula of every step must be able to rise one
+    /// level (its tier weights one level up have a positive sum).
+    /// Postcondition: The baseline run of plan from inventory is done.
+    /// </summary>
+    SensitivityAnalyzer(const PlanView& plan, const Inventory& inventory);
+
+    /// <summary>
+    /// Baseline function
+    /// Precondition: Some step must use target.
+    /// Postcondition: The target stock after the baseline run is returned.
+    /// </summary>
+    Quantity baseline(const std::string& target) const;
+
+    /// <summary>
+    /// Gain function
+    /// Precondition: step must be a valid step index, and some step must use
+    /// target.
+    /// Postcondition: The change of the final target stock when the formula
+    /// of step is one level higher is returned.
+    /// </summary>
+    Quantity gain(int step, const std::string& target) const;
+
+    /// <summary>
+    /// Rank function
+    /// Precondition: Some step must use target. threads must be
+    /// non-negative (0 for one per core).
+    /// Postcondition: The gain of every step is returned, largest first
+    /// (ties by step index). Steps are evaluated on several threads.
+    /// </summary>
+    std::vector<UpgradeGain> rank(const std::string& target,
+                                  int threads = 0) const;
+};
+
+#endif // !SENSITIVITY_H
@@ -0,0 +1,777 @@
+#include "server.h"
+#include "binary.h"
+#include "random.h"
+#include <stdexcept>
+#include <system_error>
+#include <algorithm>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the classes.
+ */
+
+/*
+ * This is the implementation of server.h. SimulationServer is a single
+ * threaded poll() event loop over a Unix domain socket; SimulationClient is
+ * the blocking counterpart used by tools.
+ *
+ * Implementation Invariant:
+ * Every client keeps the bytes it has sent that don't yet form a complete
+ * frame, and the bytes of responses not yet written. A pass of the event
+ * loop reads everything that is ready, answers all complete frames as one
+ * batch against one catalog snapshot, and queues the responses in request
+ * order, so each client sees its responses in the order it sent requests.
+ * A bill of materials or a simulation of more than INLINE_CRAFTS crafts is
+ * not answered in the pass: it is queued, with the snapshot, as a job of
+ * its own for the worker pool, and a Reply placeholder takes its place in
+ * the client's reply queue. When PARALLEL_BATCH or more requests remain,
+ * they are queued too, in jobs of PARALLEL_BATCH, so the event loop only
+ * ever answers a few short requests itself. Responses behind a placeholder
+ * wait in the queue too, and each pass moves the ready replies at the front
+ * of every queue to its output, so the order holds. The pool wakes the
+ * event loop through a pipe. Bills of materials use the RatioSolver the
+ * catalog built with the snapshot, so no thread ever builds one.
+ *
+ * Error Processing:
+ * Socket setup failures throw an std::system_error exception. A bad request
+ * (unknown operation, bad index, truncated payload, a simulation of more
+ * than MAX_CRAFTS crafts, or an error from the solver) is answered with a
+ * FAILED response holding the message instead of stopping the server. A client that sends a malformed frame or fails to
+ * read its responses is disconnected. SimulationClient throws an
+ * std::runtime_error exception for FAILED responses.
+ *
+ * Assumptions:
+ * Clients and server run on the same host, so frames use host byte order.
+ */
+
+namespace
+{
+    // size of the frame length, id and code fields
+    const int LENGTH = sizeof(int);
+    const int HEADER = 2 * sizeof(int);
+
+    // largest frame accepted, in bytes
+    const int MAX_FRAME = 16 << 20;
+
+    // bytes read from a socket at a time
+    const int CHUNK = 64 << 10;
+
+    // short requests from which a batch is answered on the pool, and the
+    // most requests of one job
+    const std::size_t PARALLEL_BATCH = 64;
+
+#ifdef MSG_NOSIGNAL
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    const int SEND_FLAGS = 0;
+#endif
+
+    // throws the error of the last failed system call
+    void fail(const char* what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    // keeps a closed peer from raising SIGPIPE where MSG_NOSIGNAL is missing
+    void ignorePipe(int socket)
+    {
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#else
+        (void)socket;
+#endif
+    }
+
+    // fills a socket address for path
+    sockaddr_un addressOf(const std::string& path)
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+            throw std::invalid_argument("socket path is empty or too long.");
+
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+
+    // returns a frame holding id, code and payload
+    std::string frame(int id, int code, const std::string& payload)
+    {
+        BinaryWriter writer;
+        writer.reserve(LENGTH + HEADER + payload.size());
+        writer.writeInt(HEADER + static_cast<int>(payload.size()));
+        writer.writeInt(id);
+        writer.writeInt(code);
+        writer.writeBytes(payload.data(), payload.size());
+        return writer.takeBuffer();
+    }
+
+    void writeInventory(BinaryWriter& writer, const Inventory& inventory)
+    {
+        writer.writeInt(static_cast<int>(inventory.size()));
+        for (const auto& material : inventory)
+        {
+            writer.writeString(material.first);
+            writer.writeLong(material.second.getRaw());
+        }
+    }
+
+    Inventory readInventory(BinaryReader& reader)
+    {
+        Inventory inventory;
+        int count = reader.readInt();
+        for (int i = 0; i < count; ++i)
+        {
+            std::string name = reader.readString();
+            inventory[name] = Quantity::fromRaw(reader.readLong());
+        }
+        return inventory;
+    }
+
+    // sends every byte or throws
+    void sendAll(int socket, const std::string& bytes)
+    {
+        std::size_t sent = 0;
+        while (sent < bytes.size())
+        {
+            ssize_t n = ::send(socket, bytes.data() + sent,
+                               bytes.size() - sent, SEND_FLAGS);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                fail("send");
+            sent += n;
+        }
+    }
+
+    // receives exactly size bytes or throws
+    void receiveAll(int socket, char* out, std::size_t size)
+    {
+        std::size_t received = 0;
+        while (received < size)
+        {
+            ssize_t n = ::recv(socket, out + received, size - received, 0);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                fail("recv");
+            if (n == 0)
+                throw std::runtime_error("server closed the connection.");
+            received += n;
+        }
+    }
+}
+
+// Constructor
+SimulationServer::SimulationServer(Catalog& catalog, const std::string& path)
+        : catalog(catalog), path(path), listener(-1), wake{-1, -1},
+          stopping(false), closing(false)
+{
+    sockaddr_un address = addressOf(path);
+
+    if (::pipe(wake) < 0)
+        fail("pipe");
+
+    listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 ||
+        ::fcntl(wake[0], F_SETFL, O_NONBLOCK) < 0 ||
+        ::fcntl(wake[1], F_SETFL, O_NONBLOCK) < 0)
+    {
+        int error = errno;
+        if (listener >= 0)
+            ::close(listener);
+        ::close(wake[0]);
+        ::close(wake[1]);
+        errno = error;
+        fail("socket");
+    }
+
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address),
+               sizeof(address)) < 0 ||
+        ::listen(listener, SOMAXCONN) < 0 ||
+        ::fcntl(listener, F_SETFL, O_NONBLOCK) < 0)
+    {
+        int error = errno;
+        ::close(listener);
+        ::close(wake[0]);
+        ::close(wake[1]);
+        errno = error;
+        fail("listen");
+    }
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 0; t < threads; ++t)
+        pool.emplace_back(&SimulationServer::work, this);
+}
+
+// Destructor
+SimulationServer::~SimulationServer()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueing);
+        closing = true;
+    }
+    queued.notify_all();
+    for (std::thread& thread : pool)
+        thread.join();
+
+    for (Client& client : clients)
+        ::close(client.socket);
+
+    ::close(wake[0]);
+    ::close(wake[1]);
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+
+// Answer function
+void SimulationServer::answer(Request& request,
+                              const CatalogSnapshot& snapshot) const
+{
+    const Plan& formulas = snapshot.formulas;
+    BinaryReader reader(request.payload.data(), request.payload.size());
+    BinaryWriter writer;
+
+    try
+    {
+        switch (request.operation)
+        {
+            case SIMULATE:
+            {
+                Random rng(reader.readUnsigned());
+                int repetitions = reader.readInt();
+                if (repetitions < 0)
+                    throw std::invalid_argument
+                            ("repetitions should be non-negative.");
+
+                int count = reader.readInt();
+                if (count < 0 || static_cast<std::size_t>(count) >
+                        reader.remaining() / sizeof(int))
+                    throw std::invalid_argument("bad step count.");
+
+                long long crafts = static_cast<long long>(repetitions) *
+                        std::max(1, count == 0 ? formulas.getSize() : count);
+                if (crafts > MAX_CRAFTS)
+                    throw std::invalid_argument("simulation too long.");
+
+                std::vector<const Formula*> steps(count);
+                for (const Formula*& step : steps)
+                    step = &formulas.getFormula(reader.readInt());
+
+                Inventory inventory = readInventory(reader);
+                long long crafted = 0;
+
+                for (int r = 0; r < repetitions; ++r)
+                {
+                    if (steps.empty())
+                        crafted += formulas.simulate(rng, inventory);
+
+                    for (const Formula* step : steps)
+                        crafted += step->craft(rng, inventory);
+                }
+
+                writer.writeLong(crafted);
+                writeInventory(writer, inventory);
+                break;
+            }
+
+            case EXPECTED:
+            {
+                const Formula& formula = formulas.getFormula(reader.readInt());
+                Quantity rate = formula.expectedRate();
+                Inventory outputs;
+                formula.collect(rate, outputs);
+
+                writer.writeLong(rate.getRaw());
+                writeInventory(writer, outputs);
+                break;
+            }
+
+            case BILL:
+            {
+                std::map<std::string, double> targets;
+                int count = reader.readInt();
+                for (int i = 0; i < count; ++i)
+                {
+                    std::string name = reader.readString();
+                    targets[name] = reader.readDouble();
+                }
+
+                RatioSolution solution = snapshot.solver.solve(targets);
+
+                int used = static_cast<int>(std::count_if(
+                        solution.crafts.begin(), solution.crafts.end(),
+                        [](double crafts) { return crafts != 0; }));
+                writer.writeInt(static_cast<int>(solution.crafts.size()));
+                writer.writeInt(used);
+                for (std::size_t f = 0; f < solution.crafts.size(); ++f)
+                {
+                    if (solution.crafts[f] != 0)
+                    {
+                        writer.writeInt(static_cast<int>(f));
+                        writer.writeDouble(solution.crafts[f]);
+                    }
+                }
+
+                writer.writeInt(static_cast<int>(solution.net.size()));
+                for (const auto& material : solution.net)
+                {
+                    writer.writeString(material.first);
+                    writer.writeDouble(material.second);
+                }
+                break;
+            }
+
+            default:
+                throw std::invalid_argument("unknown operation.");
+        }
+
+        request.response = frame(request.id, OK, writer.getBuffer());
+    }
+    catch (std::exception& e)
+    {
+        request.response = frame(request.id, FAILED, e.what());
+    }
+}
+
+// Is long function
+bool SimulationServer::isLong(const Request& request,
+                              const CatalogSnapshot& snapshot)
+{
+    // a solve over a catalog with loops can take far longer than a pass
+    if (request.operation == BILL)
+        return true;
+    if (request.operation != SIMULATE)
+        return false;
+
+    // a payload too short to read, or a simulation answer() refuses, is
+    // answered, and failed, in the pass
+    BinaryReader reader(request.payload.data(), request.payload.size());
+    try
+    {
+        reader.readUnsigned();
+        int repetitions = reader.readInt();
+        int count = reader.readInt();
+        if (repetitions < 0 || count < 0)
+            return false;
+
+        long long crafts = static_cast<long long>(repetitions) * std::max(1,
+                count == 0 ? snapshot.formulas.getSize() : count);
+        return crafts > INLINE_CRAFTS && crafts <= MAX_CRAFTS;
+    }
+    catch (std::exception&)
+    {
+        return false;
+    }
+}
+
+// Work function
+void SimulationServer::work()
+{
+    std::unique_lock<std::mutex> lock(queueing);
+
+    while (true)
+    {
+        queued.wait(lock, [this]() { return closing || !jobs.empty(); });
+        if (closing)
+            return;
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+
+        for (std::size_t i = 0; i < job.requests.size(); ++i)
+        {
+            answer(job.requests[i], *job.snapshot);
+            job.replies[i]->bytes = std::move(job.requests[i].response);
+            job.replies[i]->ready = true;
+        }
+
+        // a full pipe already holds a wake-up, so a failed write is fine
+        char byte = 0;
+        while (::write(wake[1], &byte, 1) < 0 && errno == EINTR)
+            continue;
+
+        lock.lock();
+    }
+}
+
+// Receive function
+bool SimulationServer::receive(int index, std::vector<Request>& batch)
+{
+    Client& client = clients[index];
+    char buffer[CHUNK];
+    bool open = true;
+
+    while (true)
+    {
+        ssize_t n = ::recv(client.socket, buffer, sizeof(buffer), 0);
+        if (n > 0)
+        {
+            client.input.append(buffer, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        open = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        break;
+    }
+
+    // split the input into complete frames
+    std::size_t offset = 0;
+    while (client.input.size() - offset >= static_cast<std::size_t>(LENGTH))
+    {
+        BinaryReader reader(client.input.data() + offset, LENGTH);
+        int length = reader.readInt();
+        if (length < HEADER || length > MAX_FRAME)
+            return false;
+        if (client.input.size() - offset < static_cast<std::size_t>(
+                LENGTH + length))
+            break;
+
+        BinaryReader header(client.input.data() + offset + LENGTH, HEADER);
+        Request request;
+        request.client = index;
+        request.id = header.readInt();
+        request.operation = header.readInt();
+        request.payload.assign(client.input, offset + LENGTH + HEADER,
+                               length - HEADER);
+        batch.push_back(std::move(request));
+
+        offset += LENGTH + length;
+    }
+    client.input.erase(0, offset);
+
+    return open;
+}
+
+// Flush function
+bool SimulationServer::flush(Client& client)
+{
+    while (!client.output.empty())
+    {
+        ssize_t n = ::send(client.socket, client.output.data(),
+                           client.output.size(), SEND_FLAGS);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        if (n <= 0)
+            return false;
+
+        client.output.erase(0, n);
+    }
+
+    return true;
+}
+
+// Serve once function
+int SimulationServer::serveOnce(int timeout)
+{
+    // the listener and the wake pipe come before the clients
+    const std::size_t FIRST = 2;
+
+    std::vector<pollfd> events(clients.size() + FIRST);
+    events[0].fd = listener;
+    events[0].events = POLLIN;
+    events[1].fd = wake[0];
+    events[1].events = POLLIN;
+    for (std::size_t i = 0; i < clients.size(); ++i)
+    {
+        events[i + FIRST].fd = clients[i].socket;
+        events[i + FIRST].events = POLLIN;
+        if (!clients[i].output.empty())
+            events[i + FIRST].events |= POLLOUT;
+    }
+
+    if (::poll(events.data(), events.size(), timeout) < 0)
+    {
+        if (errno == EINTR)
+            return 0;
+        fail("poll");
+    }
+
+    // empty the wake pipe; the replies it announced are collected below
+    if (events[1].revents & POLLIN)
+    {
+        char drain[64];
+        while (::read(wake[0], drain, sizeof(drain)) > 0)
+            continue;
+    }
+
+    // read every ready client into one batch
+    std::vector<Request> batch;
+    std::vector<char> closed(clients.size(), false);
+    for (std::size_t i = 0; i < clients.size(); ++i)
+    {
+        if (events[i + FIRST].revents & (POLLIN | POLLHUP | POLLERR))
+            closed[i] = !receive(static_cast<int>(i), batch);
+    }
+
+    if (!batch.empty())
+    {
+        std::shared_ptr<const CatalogSnapshot> snapshot = catalog.acquire();
+
+        // bills and long simulations go to the pool one job each, and so
+        // do the short requests of a large batch, in jobs of PARALLEL_BATCH
+        std::vector<char> deferred(batch.size());
+        std::size_t inlined = 0;
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            deferred[i] = isLong(batch[i], *snapshot);
+            inlined += !deferred[i] && !closed[batch[i].client];
+        }
+        bool parallel = inlined >= PARALLEL_BATCH;
+
+        std::vector<Job> queue;
+        Job shared{std::vector<Request>(), snapshot,
+                   std::vector<std::shared_ptr<Reply>>()};
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            Request& request = batch[i];
+            if (closed[request.client])
+                continue;
+
+            Client& client = clients[request.client];
+            if (!deferred[i] && !parallel)
+            {
+                answer(request, *snapshot);
+                if (client.replies.empty())
+                    client.output += request.response;
+                else
+                {
+                    std::shared_ptr<Reply> reply = std::make_shared<Reply>();
+                    reply->bytes = std::move(request.response);
+                    reply->ready = true;
+                    client.replies.push_back(reply);
+                }
+                continue;
+            }
+
+            std::shared_ptr<Reply> reply = std::make_shared<Reply>();
+            reply->ready = false;
+            client.replies.push_back(reply);
+
+            if (deferred[i])
+            {
+                Job job{std::vector<Request>(), snapshot, {reply}};
+                job.requests.push_back(std::move(request));
+                queue.push_back(std::move(job));
+            }
+            else
+            {
+                shared.requests.push_back(std::move(request));
+                shared.replies.push_back(reply);
+                if (shared.requests.size() == PARALLEL_BATCH)
+                {
+                    queue.push_back(std::move(shared));
+                    shared = Job{std::vector<Request>(), snapshot,
+                                 std::vector<std::shared_ptr<Reply>>()};
+                }
+            }
+        }
+        if (!shared.requests.empty())
+            queue.push_back(std::move(shared));
+
+        if (!queue.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(queueing);
+                for (Job& job : queue)
+                    jobs.push_back(std::move(job));
+            }
+            queued.notify_all();
+        }
+    }
+
+    for (std::size_t i = 0; i < clients.size(); ++i)
+    {
+        if (closed[i])
+            continue;
+
+        // move the replies that are ready, in order, to the output
+        Client& client = clients[i];
+        while (!client.replies.empty() && client.replies.front()->ready)
+        {
+            client.output += client.replies.front()->bytes;
+            client.replies.pop_front();
+        }
+
+        if (!flush(client))
+            closed[i] = true;
+    }
+
+    // drop closed clients, keeping the order of the others
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < clients.size(); ++i)
+    {
+        if (closed[i])
+            ::close(clients[i].socket);
+        else if (kept++ != i)
+            clients[kept - 1] = std::move(clients[i]);
+    }
+    clients.resize(kept);
+
+    // accept new connections last so indices above stay valid
+    if (events[0].revents & POLLIN)
+    {
+        int socket;
+        while ((socket = ::accept(listener, nullptr, nullptr)) >= 0)
+        {
+            ::fcntl(socket, F_SETFL, O_NONBLOCK);
+            ignorePipe(socket);
+            clients.push_back(Client{socket, std::string(),
+                                     std::deque<std::shared_ptr<Reply>>(),
+                                     std::string()});
+        }
+    }
+
+    return static_cast<int>(batch.size());
+}
+
+// Run function
+void SimulationServer::run()
+{
+    const int POLL_MS = 100;
+
+    while (!stopping)
+        serveOnce(POLL_MS);
+}
+
+// Stop function
+void SimulationServer::stop()
+{
+    stopping = true;
+}
+
+// Client constructor
+SimulationClient::SimulationClient(const std::string& path)
+        : socket(-1), nextId(0)
+{
+    sockaddr_un address = addressOf(path);
+
+    socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket < 0)
+        fail("socket");
+
+    if (::connect(socket, reinterpret_cast<sockaddr*>(&address),
+                  sizeof(address)) < 0)
+    {
+        int error = errno;
+        ::close(socket);
+        errno = error;
+        fail("connect");
+    }
+    ignorePipe(socket);
+}
+
+// Client destructor
+SimulationClient::~SimulationClient()
+{
+    ::close(socket);
+}
+
+// Call function
+std::string SimulationClient::call(int operation, const std::string& payload)
+{
+    sendAll(socket, frame(nextId++, operation, payload));
+
+    char header[LENGTH + HEADER];
+    receiveAll(socket, header, sizeof(header));
+
+    BinaryReader reader(header, sizeof(header));
+    int length = reader.readInt();
+    reader.readInt();
+    int status = reader.readInt();
+    if (length < HEADER || length > MAX_FRAME)
+        throw std::runtime_error("malformed response.");
+
+    std::string body(length - HEADER, '\0');
+    receiveAll(socket, &body[0], body.size());
+
+    if (status != SimulationServer::OK)
+        throw std::runtime_error(body);
+
+    return body;
+}
+
+// Simulate function
+long long SimulationClient::simulate(unsigned long long seed,
+                                     int repetitions,
+                                     const std::vector<int>& steps,
+                                     Inventory& inventory)
+{
+    BinaryWriter writer;
+    writer.writeUnsigned(seed);
+    writer.writeInt(repetitions);
+    writer.writeInt(static_cast<int>(steps.size()));
+    for (int step : steps)
+        writer.writeInt(step);
+    writeInventory(writer, inventory);
+
+    std::string body = call(SimulationServer::SIMULATE, writer.getBuffer());
+    BinaryReader reader(body.data(), body.size());
+    long long crafted = reader.readLong();
+    inventory = readInventory(reader);
+
+    return crafted;
+}
+
+// Expected yield function
+Inventory SimulationClient::expectedYield(int index)
+{
+    BinaryWriter writer;
+    writer.writeInt(index);
+
+    std::string body = call(SimulationServer::EXPECTED, writer.getBuffer());
+    BinaryReader reader(body.data(), body.size());
+    reader.readLong();
+
+    return readInventory(reader);
+}
+
+// Bill of materials function
+RatioSolution SimulationClient::billOfMaterials(
+        const std::map<std::string, double>& targets)
+{
+    BinaryWriter writer;
+    writer.writeInt(static_cast<int>(targets.size()));
+    for (const auto& target : targets)
+    {
+        writer.writeString(target.first);
+        writer.writeDouble(target.second);
+    }
+
+    std::string body = call(SimulationServer::BILL, writer.getBuffer());
+    BinaryReader reader(body.data(), body.size());
+
+    RatioSolution solution;
+    solution.crafts.assign(reader.readInt(), 0.0);
+    int used = reader.readInt();
+    for (int i = 0; i < used; ++i)
+    {
+        int index = reader.readInt();
+        solution.crafts.at(index) = reader.readDouble();
+    }
+
+    int count = reader.readInt();
+    for (int i = 0; i < count; ++i)
+    {
+        std::string name = reader.readString();
+        solution.net[name] = reader.readDouble();
+    }
+
+    return solution;
+}
@@ -0,0 +1,244 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "catalog.h"
+#include "solver.h"
+#include "quantity.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the classes.
+ */
+
+/*
+ * Protocol: every message is a frame of
+ *   int length (bytes after this field), int id, int code, payload
+ * written with BinaryWriter. For a request the code is the Operation; for a
+ * response it is OK or FAILED, and a FAILED payload is the error message.
+ *
+ *   SIMULATE  request:  unsigned seed, int repetitions,
+ *                       int steps, steps x int formula index, inventory
+ *                       (0 steps runs the whole catalog in order)
+ *             response: long crafted, inventory
+ *   EXPECTED  request:  int formula index
+ *             response: long expected rate (raw), outputs as an inventory
+ *   BILL      request:  int targets, targets x (string material, double rate)
+ *             response: int formulas (catalog size), int used,
+ *                       used x (int index, double crafts) for the formulas
+ *                       with non-zero crafts,
+ *                       int materials, materials x (string, double net rate)
+ *
+ * An inventory is int count, count x (string material, long raw quantity).
+ */
+
+/// <summary>
+/// Class representing a local simulation daemon listening on a Unix domain
+/// socket.
+/// It serves simulate, expected-yield and bill-of-materials requests
+/// against a shared Catalog. Each pass of the event loop gathers every
+/// complete request from every client into one batch, which is answered
+/// against a single catalog snapshot (with the RatioSolver the catalog built
+/// for it) and flushed with one write per client. Bills of materials,
+/// simulations of more than INLINE_CRAFTS crafts and the requests of a
+/// large batch are answered on a persistent worker pool so they never hold
+/// up the event loop; each client still receives its responses in request
+/// order.
+/// Class Invariant: The listening socket is open until destruction.
+/// </summary>
+class SimulationServer
+{
+public:
+    // request operations
+    enum Operation { SIMULATE = 1, EXPECTED = 2, BILL = 3 };
+
+    // response status codes
+    enum Status { OK = 0, FAILED = 1 };
+
+    // most crafts a simulation is answered with on the event loop
+    static const long long INLINE_CRAFTS = 1 << 12;
+
+    // most crafts one simulation request may ask for; a pass over no steps
+    // counts as one craft, so an empty catalog can't loop unbounded
+    static const long long MAX_CRAFTS = 1LL << 26;
+
+private:
+    // holds a response that may still be computed on the pool
+    struct Reply
+    {
+        std::string bytes;
+        std::atomic<bool> ready;
+    };
+
+    // holds one connection, its unparsed input, the responses waiting for
+    // an earlier one on the pool, and unsent output
+    struct Client
+    {
+        int socket;
+        std::string input;
+        std::deque<std::shared_ptr<Reply>> replies;
+        std::string output;
+    };
+
+    // holds one parsed request of the current batch
+    struct Request
+    {
+        int client;
+        int id;
+        int operation;
+        std::string payload;
+        std::string response;
+    };
+
+    // holds requests the pool answers in order against one snapshot
+    struct Job
+    {
+        std::vector<Request> requests;
+        std::shared_ptr<const CatalogSnapshot> snapshot;
+        std::vector<std::shared_ptr<Reply>> replies;
+    };
+
+    Catalog& catalog;                   // formulas being served
+    std::string path;                   // socket file
+    int listener;                       // listening socket
+    int wake[2];                        // pipe the pool wakes the event
+                                        // loop through
+    std::vector<Client> clients;        // open connections
+    std::atomic<bool> stopping;         // set by stop()
+
+    // jobs and the threads answering them
+    std::mutex queueing;
+    std::condition_variable queued;
+    std::deque<Job> jobs;
+    bool closing;
+    std::vector<std::thread> pool;
+
+    // answers one request against snapshot
+    void answer(Request& request, const CatalogSnapshot& snapshot) const;
+
+    // returns true when a request is too slow for the event loop
+    static bool isLong(const Request& request,
+                       const CatalogSnapshot& snapshot);
+
+    // answers jobs until the server closes
+    void work();
+
+    // reads frames from a readable client, false when it closed
+    bool receive(int index, std::vector<Request>& batch);
+
+    // writes pending output, false when the client failed
+    bool flush(Client& client);
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: path must be a writable socket path.
+    /// Postcondition: A server listening on path and serving catalog is
+    /// created. An old socket file at path is replaced.
+    /// </summary>
+    SimulationServer(Catalog& catalog, const std::string& path);
+
+    SimulationServer(const SimulationServer&) = delete;
+    SimulationServer& operator=(const SimulationServer&) = delete;
+
+    /// <summary>
+    /// Destructor
+    /// Precondition: None.
+    /// Postcondition: The pool is joined (dropping the jobs it hasn't
+    /// started), every connection is closed and the socket file is removed.
+    /// </summary>
+    ~SimulationServer();
+
+    /// <summary>
+    /// Serve Once function
+    /// Precondition: timeout is in milliseconds (negative waits forever).
+    /// Postcondition: New connections are accepted, and every request that
+    /// arrived within timeout is answered as one batch; bills, long
+    /// simulations and large batches are handed to the pool and sent on a
+    /// later pass. The number of requests received is returned.
+    /// </summary>
+    int serveOnce(int timeout);
+
+    /// <summary>
+    /// Run function
+    /// Precondition: None.
+    /// Postcondition: Requests are served until stop() is called.
+    /// </summary>
+    void run();
+
+    /// <summary>
+    /// Stop function
+    /// Precondition: None.
+    /// Postcondition: run() returns after its current pass. Safe to call
+    /// from another thread.
+    /// </summary>
+    void stop();
+};
+
+/// <summary>
+/// Class representing a connection to a SimulationServer.
+/// Class Invariant: The socket is connected until destruction.
+/// </summary>
+class SimulationClient
+{
+private:
+    int socket;         // connected socket
+    int nextId;         // id of the next request
+
+    // sends a request and waits for its response payload
+    std::string call(int operation, const std::string& payload);
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: A server must be listening on path.
+    /// Postcondition: A client connected to the server is created.
+    /// </summary>
+    explicit SimulationClient(const std::string& path);
+
+    SimulationClient(const SimulationClient&) = delete;
+    SimulationClient& operator=(const SimulationClient&) = delete;
+
+    /// <summary>
+    /// Destructor
+    /// Precondition: None.
+    /// Postcondition: The connection is closed.
+    /// </summary>
+    ~SimulationClient();
+
+    /// <summary>
+    /// Simulate function
+    /// Precondition: Every step must be a valid catalog index, and
+    /// repetitions must be non-negative.
+    /// Postcondition: The steps (the whole catalog when empty) are simulated
+    /// repetitions times on inventory with a stream seeded by seed; the
+    /// number of steps crafted is returned and inventory holds the result.
+    /// Requests of more than SimulationServer::MAX_CRAFTS crafts
+    /// (repetitions times the number of steps, at least one) fail.
+    /// </summary>
+    long long simulate(unsigned long long seed, int repetitions,
+                       const std::vector<int>& steps, Inventory& inventory);
+
+    /// <summary>
+    /// Expected Yield function
+    /// Precondition: index must be a valid catalog index.
+    /// Postcondition: The expected outputs of one craft are returned.
+    /// </summary>
+    Inventory expectedYield(int index);
+
+    /// <summary>
+    /// Bill Of Materials function
+    /// Precondition: Same as RatioSolver::solve.
+    /// Postcondition: The steady-state ratios for targets are returned.
+    /// </summary>
+    RatioSolution billOfMaterials(const std::map<std::string, double>& targets);
+};
+
+#endif // !SERVER_H
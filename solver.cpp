@@ -0,0 +1,661 @@
+#include "solver.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/*
+ * This is the implementation of solver.h. The RatioSolver class computes how
+ * many crafts per second of each formula are needed to produce target
+ * material rates, including catalogs with loops such as catalysts or
+ * byproducts that feed back into earlier formulas.
+ *
+ * Implementation Invariant:
+ * The recipe matrix is stored twice, by formula (columns) and by material
+ * (rows), holding only the non-zero expected net amounts. Solving first walks
+ * from the targets to find the needed materials and formulas; every needed
+ * material with a producer is owned by that formula, and each needed formula
+ * is keyed by the first material it was reached for. Every owned material
+ * gives a balance inequality (net production at least its demand). Formula A
+ * depends on formula B when B appears in the row of a material A owns. The
+ * strongly connected components of that graph are found with an iterative
+ * Tarjan search, which emits each component after every component it
+ * depends on, so components are solved in emission order. A single formula
+ * runs at the largest rate any material it owns requires. A loop is solved
+ * as one equation per member, for its key material, by sparse Gaussian
+ * elimination (Markowitz-style column order with threshold pivoting); loops
+ * of more than ITERATE_ABOVE formulas are first tried by Gauss-Seidel
+ * sweeps over the same sparse rows, which settle quickly for productive
+ * loops without the fill-in elimination can have on large ones. If another
+ * owned material then falls short, that member is keyed to it and the loop
+ * is solved again. Building and solving are linear in the number of matrix
+ * entries apart from the sweeps and fill-in of loops.
+ *
+ * Error Processing:
+ * The solve method throws an std::invalid_argument exception for a negative
+ * target or a target no formula produces, and an std::domain_error exception
+ * if a loop has no non-negative steady state meeting every demand, if its
+ * elimination fills in more than FILL_LIMIT entries, or if some needed
+ * material still ends up short.
+ *
+ * Assumptions:
+ * Produce rates are taken at the expected value for each formula's current
+ * proficiency.
+ */
+
+const int RatioSolver::NONE;
+const int RatioSolver::DEFAULT;
+
+namespace
+{
+    // tolerance for treating a rate as zero
+    const double EPSILON = 1e-9;
+
+    // relative shortfall tolerated when checking that a demand is met
+    const double TOLERANCE = 1e-6;
+
+    // a pivot must be at least this fraction of the largest in its column
+    const double THRESHOLD = 0.1;
+
+    // most matrix entries a loop elimination may hold (a dense loop of
+    // 2048 formulas still fits)
+    const std::size_t FILL_LIMIT = 1 << 22;
+
+    // loops with more formulas are first tried by Gauss-Seidel sweeps
+    const std::size_t ITERATE_ABOVE = 1024;
+
+    // sweeps tried before falling back to elimination
+    const int MAX_SWEEPS = 1000;
+
+    // relative change of a sweep below which the sweeps have settled
+    const double SETTLED = 1e-12;
+
+    // one row of a sparse loop system: (column, coefficient) by column
+    typedef std::vector<std::pair<int, double>> SparseRow;
+
+    // solves matrix * x = rhs by Gauss-Seidel sweeps from x = 0, where
+    // column r of row r is the diagonal; returns false if the sweeps don't
+    // settle within MAX_SWEEPS
+    bool iterate(const std::vector<SparseRow>& matrix,
+                 const std::vector<double>& rhs, std::vector<double>& x)
+    {
+        const int m = static_cast<int>(matrix.size());
+        std::vector<double> diagonal(m, 0.0);
+        for (int r = 0; r < m; ++r)
+        {
+            for (const auto& entry : matrix[r])
+            {
+                if (entry.first == r)
+                    diagonal[r] = entry.second;
+            }
+            if (diagonal[r] <= EPSILON)
+                return false;
+        }
+
+        x.assign(m, 0.0);
+        for (int sweep = 0; sweep < MAX_SWEEPS; ++sweep)
+        {
+            double change = 0.0, size = 0.0;
+            for (int r = 0; r < m; ++r)
+            {
+                double sum = rhs[r];
+                for (const auto& entry : matrix[r])
+                {
+                    if (entry.first != r)
+                        sum -= entry.second * x[entry.first];
+                }
+
+                const double next = sum / diagonal[r];
+                change = std::max(change, std::fabs(next - x[r]));
+                size = std::max(size, std::fabs(next));
+                x[r] = next;
+            }
+
+            if (!std::isfinite(size))
+                return false;
+            if (change <= SETTLED * std::max(1.0, size))
+                return true;
+        }
+
+        return false;
+    }
+
+    // solves the square system matrix * x = rhs in place; columns are taken
+    // fewest live rows first, and the pivot row is the shortest row whose
+    // entry is within THRESHOLD of the largest in the column
+    std::vector<double> eliminate(std::vector<SparseRow>& matrix,
+                                  std::vector<double>& rhs)
+    {
+        const int m = static_cast<int>(matrix.size());
+
+        // rows holding each column (may list rows that lost it since)
+        std::vector<std::vector<int>> users(m);
+        std::vector<int> count(m, 0);
+        std::size_t entries = 0;
+        for (int r = 0; r < m; ++r)
+        {
+            for (const auto& entry : matrix[r])
+            {
+                users[entry.first].push_back(r);
+                count[entry.first]++;
+            }
+            entries += matrix[r].size();
+        }
+
+        // (live rows, column), stale pairs are skipped when popped
+        typedef std::pair<int, int> Candidate;
+        std::priority_queue<Candidate, std::vector<Candidate>,
+                            std::greater<Candidate>> columns;
+        for (int c = 0; c < m; ++c)
+            columns.emplace(count[c], c);
+
+        auto find = [&](int r, int c) -> const double*
+        {
+            auto found = std::lower_bound
+                    (matrix[r].begin(), matrix[r].end(), c,
+                     [](const std::pair<int, double>& entry, int column)
+                     { return entry.first < column; });
+            return found != matrix[r].end() && found->first == c
+                   ? &found->second : nullptr;
+        };
+
+        std::vector<char> used(m, false), solved(m, false);
+        std::vector<std::pair<int, int>> pivots;
+        SparseRow merged;
+
+        while (!columns.empty())
+        {
+            const Candidate top = columns.top();
+            columns.pop();
+            const int c = top.second;
+            if (solved[c] || top.first != count[c])
+                continue;
+
+            double largest = 0.0;
+            for (int r : users[c])
+            {
+                const double* entry = used[r] ? nullptr : find(r, c);
+                if (entry)
+                    largest = std::max(largest, std::fabs(*entry));
+            }
+            if (largest <= EPSILON)
+                throw std::domain_error("loop has no steady state.");
+
+            int pivot = -1;
+            for (int r : users[c])
+            {
+                const double* entry = used[r] ? nullptr : find(r, c);
+                if (entry && std::fabs(*entry) >= THRESHOLD * largest &&
+                    (pivot < 0 || matrix[r].size() < matrix[pivot].size()))
+                    pivot = r;
+            }
+
+            used[pivot] = true;
+            solved[c] = true;
+            pivots.emplace_back(pivot, c);
+            for (const auto& entry : matrix[pivot])
+            {
+                if (!solved[entry.first])
+                    columns.emplace(--count[entry.first], entry.first);
+            }
+
+            const SparseRow& row = matrix[pivot];
+            const double head = *find(pivot, c);
+            for (int r : users[c])
+            {
+                const double* entry = used[r] ? nullptr : find(r, c);
+                if (!entry)
+                    continue;
+
+                // row r -= factor * pivot row, dropping column c
+                const double factor = *entry / head;
+                const SparseRow& target = matrix[r];
+                merged.clear();
+                std::size_t i = 0, j = 0;
+                while (i < target.size() || j < row.size())
+                {
+                    const int a = i < target.size() ? target[i].first : m;
+                    const int b = j < row.size() ? row[j].first : m;
+                    const int k = std::min(a, b);
+                    if (k == c)
+                    {
+                        i += a == k;
+                        j += b == k;
+                        continue;
+                    }
+
+                    if (a == b)
+                    {
+                        const double kept = target[i++].second;
+                        const double taken = factor * row[j++].second;
+                        const double value = kept - taken;
+                        if (std::fabs(value) > EPSILON *
+                                std::max(std::fabs(kept), std::fabs(taken)))
+                            merged.emplace_back(k, value);
+                        else
+                            columns.emplace(--count[k], k);
+                    }
+                    else if (a < b)
+                    {
+                        merged.push_back(target[i++]);
+                    }
+                    else
+                    {
+                        const double value = -factor * row[j++].second;
+                        if (value != 0.0)
+                        {
+                            merged.emplace_back(k, value);
+                            users[k].push_back(r);
+                            columns.emplace(++count[k], k);
+                        }
+                    }
+                }
+
+                entries += merged.size();
+                entries -= matrix[r].size();
+                if (entries > FILL_LIMIT)
+                    throw std::domain_error
+                            ("loop is too large to solve: elimination fills "
+                             "in too many entries.");
+
+                rhs[r] -= factor * rhs[pivot];
+                matrix[r].swap(merged);
+            }
+            users[c].clear();
+        }
+
+        // every pivot row only holds columns pivoted after it
+        std::vector<double> x(m, 0.0);
+        for (auto it = pivots.rbegin(); it != pivots.rend(); ++it)
+        {
+            double sum = rhs[it->first];
+            double diagonal = 0.0;
+            for (const auto& entry : matrix[it->first])
+            {
+                if (entry.first == it->second)
+                    diagonal = entry.second;
+                else
+                    sum -= entry.second * x[entry.first];
+            }
+            x[it->second] = sum / diagonal;
+        }
+
+        return x;
+    }
+}
+
+// Constructor
+RatioSolver::RatioSolver(const PlanView& catalog)
+{
+    const int formulas = catalog.getSize();
+    columns.resize(formulas);
+
+    std::vector<Entry> column;
+
+    for (int f = DEFAULT; f < formulas; ++f)
+    {
+        const Formula& formula = catalog.getFormula(f);
+        const double rate = formula.expectedRate().toDouble();
+
+        column.clear();
+        for (const auto& input : formula.getCondition())
+        {
+            column.push_back({intern(input.first), -double(input.second)});
+        }
+        for (const auto& output : formula.getResult())
+        {
+            column.push_back({intern(output.first), output.second * rate});
+        }
+
+        // merge materials that are both consumed and produced (catalysts)
+        std::sort(column.begin(), column.end(),
+                  [](const Entry& a, const Entry& b)
+                  { return a.index < b.index; });
+
+        for (std::size_t i = DEFAULT; i < column.size(); ++i)
+        {
+            double amount = column[i].amount;
+            while (i + 1 < column.size() &&
+                   column[i + 1].index == column[i].index)
+            {
+                amount += column[++i].amount;
+            }
+
+            if (std::fabs(amount) > EPSILON)
+            {
+                columns[f].push_back({column[i].index, amount});
+                rows[column[i].index].push_back({f, amount});
+            }
+        }
+    }
+
+    // the producer of a material is the formula making the most of it
+    producer.assign(names.size(), NONE);
+    for (std::size_t i = DEFAULT; i < rows.size(); ++i)
+    {
+        double best = DEFAULT;
+        for (const Entry& entry : rows[i])
+        {
+            if (entry.amount > best)
+            {
+                best = entry.amount;
+                producer[i] = entry.index;
+            }
+        }
+    }
+}
+
+// Intern function
+int RatioSolver::intern(const std::string& name)
+{
+    auto found = ids.find(name);
+    if (found != ids.end())
+        return found->second;
+
+    int id = static_cast<int>(names.size());
+    ids.emplace(name, id);
+    names.push_back(name);
+    rows.emplace_back();
+    return id;
+}
+
+// Solve function
+RatioSolution RatioSolver::solve(
+        const std::map<std::string, double>& targets) const
+{
+    const int formulas = static_cast<int>(columns.size());
+    const int materials = static_cast<int>(names.size());
+
+    RatioSolution solution;
+    solution.crafts.assign(formulas, 0.0);
+
+    std::vector<double> demand(materials, 0.0);
+    std::vector<char> visited(materials, false);
+    std::vector<int> queue;
+
+    for (const auto& target : targets)
+    {
+        auto found = ids.find(target.first);
+        if (target.second < DEFAULT)
+            throw std::invalid_argument("target rate should be non-negative.");
+        if (found == ids.end() || producer[found->second] == NONE)
+            throw std::invalid_argument
+                    ("target isn't produced by any formula: " + target.first);
+
+        demand[found->second] = target.second;
+        if (!visited[found->second])
+        {
+            visited[found->second] = true;
+            queue.push_back(found->second);
+        }
+    }
+
+    // find the needed formulas and the needed materials each one owns
+    std::vector<int> key(formulas, NONE);
+    std::vector<int> local(formulas, NONE);
+    std::vector<int> active;
+    std::vector<std::vector<int>> owned;
+
+    for (std::size_t head = DEFAULT; head < queue.size(); ++head)
+    {
+        int material = queue[head];
+        int f = producer[material];
+        if (f == NONE)
+            continue;
+
+        if (key[f] != NONE)
+        {
+            owned[local[f]].push_back(material);
+            continue;
+        }
+
+        key[f] = material;
+        local[f] = static_cast<int>(active.size());
+        active.push_back(f);
+        owned.emplace_back(1, material);
+
+        for (const Entry& entry : columns[f])
+        {
+            if (entry.amount < DEFAULT && !visited[entry.index])
+            {
+                visited[entry.index] = true;
+                queue.push_back(entry.index);
+            }
+        }
+    }
+
+    // returns the net production of material at the crafts found so far
+    auto supplied = [&](int material)
+    {
+        double net = DEFAULT;
+        for (const Entry& entry : rows[material])
+            net += entry.amount * solution.crafts[entry.index];
+        return net;
+    };
+
+    // returns true if the net production of material falls short
+    auto isShort = [&](int material)
+    {
+        return supplied(material) <
+               demand[material] - TOLERANCE * std::max(1.0, demand[material]);
+    };
+
+    // solves one strongly connected component given in members
+    std::vector<int> slot(active.size(), NONE);
+    std::vector<SparseRow> matrix;
+    std::vector<double> rhs;
+    auto solveComponent = [&](const std::vector<int>& members)
+    {
+        const std::size_t m = members.size();
+
+        if (m == 1)
+        {
+            const int v = members[0];
+            const int f = active[v];
+            double crafts = DEFAULT;
+
+            // every owned material is met at the largest rate one needs
+            for (int material : owned[v])
+            {
+                double need = demand[material];
+                double diagonal = DEFAULT;
+
+                for (const Entry& entry : rows[material])
+                {
+                    if (entry.index == f)
+                        diagonal = entry.amount;
+                    else
+                        need -= entry.amount * solution.crafts[entry.index];
+                }
+
+                crafts = std::max(crafts, need / diagonal);
+            }
+
+            // byproducts may already cover the demand
+            solution.crafts[f] = crafts;
+            return;
+        }
+
+        std::size_t limit = DEFAULT;
+        for (std::size_t r = DEFAULT; r < m; ++r)
+        {
+            slot[members[r]] = static_cast<int>(r);
+            limit += owned[members[r]].size();
+        }
+
+        // a member whose other material falls short is keyed to it instead
+        for (std::size_t attempt = DEFAULT; ; ++attempt)
+        {
+            matrix.assign(m, SparseRow());
+            rhs.assign(m, 0.0);
+            for (std::size_t r = DEFAULT; r < m; ++r)
+            {
+                int material = key[active[members[r]]];
+                rhs[r] = demand[material];
+
+                for (const Entry& entry : rows[material])
+                {
+                    int column = local[entry.index] == NONE
+                            ? NONE : slot[local[entry.index]];
+                    if (column == NONE)
+                        rhs[r] -= entry.amount * solution.crafts[entry.index];
+                    else
+                        matrix[r].emplace_back(column, entry.amount);
+                }
+                std::sort(matrix[r].begin(), matrix[r].end());
+            }
+
+            std::vector<double> crafts;
+            if (m <= ITERATE_ABOVE || !iterate(matrix, rhs, crafts))
+                crafts = eliminate(matrix, rhs);
+            for (std::size_t r = DEFAULT; r < m; ++r)
+            {
+                if (crafts[r] < -EPSILON)
+                    throw std::domain_error
+                            ("loop consumes more than it produces.");
+
+                solution.crafts[active[members[r]]] =
+                        std::max(crafts[r], 0.0);
+            }
+
+            int rekeyed = NONE;
+            for (std::size_t r = DEFAULT; r < m && rekeyed == NONE; ++r)
+            {
+                for (int material : owned[members[r]])
+                {
+                    if (isShort(material))
+                    {
+                        key[active[members[r]]] = material;
+                        rekeyed = material;
+                        break;
+                    }
+                }
+            }
+
+            if (rekeyed == NONE)
+                break;
+            if (attempt >= limit)
+                throw std::domain_error
+                        ("loop can't meet every demand at once: "
+                         + names[rekeyed]);
+        }
+
+        for (std::size_t r = DEFAULT; r < m; ++r)
+        {
+            slot[members[r]] = NONE;
+        }
+    };
+
+    // dependencies of each needed formula, from the rows of its materials
+    const int count = static_cast<int>(active.size());
+    std::vector<int> start(count + 1, DEFAULT), depends;
+    for (int v = DEFAULT; v < count; ++v)
+    {
+        for (int material : owned[v])
+        {
+            for (const Entry& entry : rows[material])
+            {
+                int w = local[entry.index];
+                if (w != NONE && w != v)
+                    depends.push_back(w);
+            }
+        }
+        start[v + 1] = static_cast<int>(depends.size());
+    }
+
+    // iterative Tarjan search over the needed formulas
+    std::vector<int> order(count, NONE), low(count, NONE);
+    std::vector<char> onStack(count, false);
+    std::vector<int> stack, members;
+    std::vector<std::pair<int, int>> calls;
+    int counter = DEFAULT;
+
+    for (int root = DEFAULT; root < count; ++root)
+    {
+        if (order[root] != NONE)
+            continue;
+
+        order[root] = low[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = true;
+        calls.emplace_back(root, start[root]);
+
+        while (!calls.empty())
+        {
+            int v = calls.back().first;
+
+            if (calls.back().second < start[v + 1])
+            {
+                int w = depends[calls.back().second++];
+
+                if (order[w] == NONE)
+                {
+                    order[w] = low[w] = counter++;
+                    stack.push_back(w);
+                    onStack[w] = true;
+                    calls.emplace_back(w, start[w]);
+                }
+                else if (onStack[w])
+                {
+                    low[v] = std::min(low[v], order[w]);
+                }
+                continue;
+            }
+
+            if (low[v] == order[v])
+            {
+                members.clear();
+                int w;
+                do
+                {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = false;
+                    members.push_back(w);
+                } while (w != v);
+
+                solveComponent(members);
+            }
+
+            calls.pop_back();
+            if (!calls.empty())
+            {
+                int u = calls.back().first;
+                low[u] = std::min(low[u], low[v]);
+            }
+        }
+    }
+
+    // every target and intermediate must be met
+    for (int v = DEFAULT; v < count; ++v)
+    {
+        for (int material : owned[v])
+        {
+            if (isShort(material))
+                throw std::domain_error
+                        ("demand isn't met: " + names[material]);
+        }
+    }
+
+    // net production of every material touched
+    std::vector<double> net(materials, 0.0);
+    for (int f : active)
+    {
+        for (const Entry& entry : columns[f])
+        {
+            net[entry.index] += entry.amount * solution.crafts[f];
+        }
+    }
+    for (int i = DEFAULT; i < materials; ++i)
+    {
+        if (std::fabs(net[i]) > EPSILON)
+            solution.net[names[i]] = net[i];
+    }
+
+    return solution;
+}
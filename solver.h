@@ -0,0 +1,90 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "plan.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the class.
+ */
+
+/// <summary>
+/// Result of a steady-state ratio calculation.
+/// crafts holds the crafts per second of each formula, indexed like the
+/// catalog Plan (zero for formulas that are not needed). net holds the net
+/// production per second of every material involved: the targets, surplus
+/// byproducts (positive) and raw inputs that must be supplied (negative).
+/// </summary>
+struct RatioSolution
+{
+    std::vector<double> crafts;
+    std::map<std::string, double> net;
+};
+
+/// <summary>
+/// Class representing a steady-state ratio solver over a formula catalog.
+/// The catalog is turned into a sparse recipe matrix whose entry for
+/// material i and formula f is the expected net amount of i produced by one
+/// craft of f. Every material made by some formula is assigned the formula
+/// that makes the most of it as its producer; materials nobody makes are raw
+/// inputs. A formula that is the producer of several needed materials runs
+/// at the largest rate any of them requires.
+/// Class Invariant: The matrix columns match the catalog the solver was
+/// built from, and every material has at most one producer.
+/// </summary>
+class RatioSolver
+{
+private:
+    // one non-zero entry of the recipe matrix
+    struct Entry
+    {
+        int index;          // material (in a column) or formula (in a row)
+        double amount;      // expected net amount per craft
+    };
+
+    // holds material names by material id
+    std::vector<std::string> names;
+
+    // holds material ids by name
+    std::map<std::string, int> ids;
+
+    // holds the matrix by formula (column) and by material (row)
+    std::vector<std::vector<Entry>> columns;
+    std::vector<std::vector<Entry>> rows;
+
+    // holds the producer formula of each material, NONE for raw inputs
+    std::vector<int> producer;
+
+    // value marking a missing formula or material
+    static const int NONE = -1;
+
+    // default value
+    static const int DEFAULT = 0;
+
+    // interns a material name
+    int intern(const std::string& name);
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: None.
+    /// Postcondition: The recipe matrix of every Formula in catalog is built.
+    /// </summary>
+    RatioSolver(const PlanView& catalog);
+
+    /// <summary>
+    /// Solve function
+    /// Precondition: Every target rate must be non-negative, and the formulas
+    /// needed for the targets must have a solution with non-negative rates.
+    /// Postcondition: The crafts per second of each formula that yields at
+    /// least the target rate of every target and of every intermediate
+    /// material consumed on the way is returned; an std::domain_error is
+    /// thrown if no such rates are found. Surplus of multi-output formulas
+    /// is not balanced and shows up in the net rates instead.
+    /// </summary>
+    RatioSolution solve(const std::map<std::string, double>& targets) const;
+};
+
+#endif // !SOLVER_H
@@ -0,0 +1,194 @@
+#include "tiers.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the classes.
+ */
+
+/*
+ * This is the implementation of tiers.h. TierTable describes how likely
+ * each produce rate of a formula is at every proficiency level, and
+ * AliasTable samples such a distribution in constant time.
+ *
+ * Implementation Invariant:
+ * An AliasTable of n weights scales each weight to n * weight / sum and
+ * pairs columns below 1 with columns above 1 (Vose's method), so every
+ * column holds the chance to keep itself, in units of 2^-32, and the column
+ * that fills the rest. TierTable keeps one Level per proficiency level
+ * reached so far; a Level is never changed after it is built.
+ *
+ * Error Processing:
+ * The constructors throw an std::invalid_argument exception for an empty
+ * table, a negative rate or weight, or weights summing to zero. at throws
+ * an std::domain_error exception if every weight has dropped to zero at
+ * the level, and getTier an std::out_of_range exception for a bad index.
+ *
+ * Assumptions:
+ * None.
+ */
+
+namespace
+{
+    // a threshold of ONE always keeps the column
+    const double ONE = 4294967296.0;
+    const unsigned long long LOW_BITS = 0xFFFFFFFFULL;
+    const int HALF = 32;
+}
+
+// Alias table constructor
+AliasTable::AliasTable(const std::vector<double>& weights)
+        : threshold(weights.size()), alias(weights.size())
+{
+    const int n = static_cast<int>(weights.size());
+
+    double sum = 0;
+    for (double weight : weights)
+    {
+        if (weight < 0)
+            throw std::invalid_argument("weight should be non-negative.");
+        sum += weight;
+    }
+    if (n == 0 || !(sum > 0))
+        throw std::invalid_argument("weights should have a positive sum.");
+
+    std::vector<double> scaled(n);
+    std::vector<int> small, large;
+    for (int i = 0; i < n; ++i)
+    {
+        scaled[i] = weights[i] * n / sum;
+        alias[i] = i;
+        (scaled[i] < 1 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        int less = small.back();
+        int more = large.back();
+        small.pop_back();
+
+        threshold[less] = static_cast<unsigned long long>(
+                std::llround(scaled[less] * ONE));
+        alias[less] = more;
+
+        scaled[more] -= 1 - scaled[less];
+        if (scaled[more] < 1)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    // whatever is left is 1 up to rounding
+    for (int i : small)
+        threshold[i] = static_cast<unsigned long long>(ONE);
+    for (int i : large)
+        threshold[i] = static_cast<unsigned long long>(ONE);
+}
+
+// Alias table sample function
+int AliasTable::sample(unsigned long long draw) const
+{
+    const unsigned long long n = threshold.size();
+    const int column = static_cast<int>(((draw >> HALF) * n) >> HALF);
+
+    return (draw & LOW_BITS) < threshold[column] ? column : alias[column];
+}
+
+// Alias table get size function
+int AliasTable::getSize() const
+{
+    return static_cast<int>(threshold.size());
+}
+
+// Tier table constructor
+TierTable::TierTable(const Tier tiers[], int count)
+{
+    if (count <= 0)
+        throw std::invalid_argument("At least one tier should provide.");
+
+    double sum = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (tiers[i].rate < 0 || tiers[i].weight < 0)
+            throw std::invalid_argument
+                    ("tier rate and weight should be non-negative.");
+
+        sum += tiers[i].weight;
+        this->tiers.push_back(tiers[i]);
+    }
+
+    if (!(sum > 0))
+        throw std::invalid_argument("tier weights should have a positive sum.");
+}
+
+// Standard function
+std::shared_ptr<const TierTable> TierTable::standard()
+{
+    static const Tier STANDARD[] = {
+            { 0, 25, -5 },
+            { Quantity::ratio(3, 4), 20, -1 },
+            { 1, 50, 3 },
+            { Quantity::ratio(11, 10), 5, 3 } };
+    static const std::shared_ptr<const TierTable> table =
+            std::make_shared<const TierTable>(STANDARD, 4);
+
+    return table;
+}
+
+// Get size function
+int TierTable::getSize() const
+{
+    return static_cast<int>(tiers.size());
+}
+
+// Get tier function
+const Tier& TierTable::getTier(int index) const
+{
+    if (index < 0 || index >= getSize())
+        throw std::out_of_range("Get failed. Index out of range.");
+
+    return tiers[index];
+}
+
+// Weight at function
+double TierTable::weightAt(int index, int level) const
+{
+    const Tier& tier = getTier(index);
+
+    return std::max(tier.weight + tier.gain * level, 0.0);
+}
+
+// At function
+std::shared_ptr<const TierTable::Level> TierTable::at(int level) const
+{
+    if (level < 0)
+        throw std::invalid_argument("level should be non-negative.");
+
+    std::lock_guard<std::mutex> lock(building);
+
+    if (level < static_cast<int>(levels.size()) && levels[level])
+        return levels[level];
+
+    std::vector<double> weights(tiers.size());
+    double sum = 0, rate = 0;
+    for (int i = 0; i < getSize(); ++i)
+    {
+        weights[i] = weightAt(i, level);
+        sum += weights[i];
+        rate += weights[i] * tiers[i].rate.getRaw();
+    }
+    if (!(sum > 0))
+        throw std::domain_error("every tier weight is zero at this level.");
+
+    std::shared_ptr<const Level> built = std::make_shared<const Level>(
+            Level{AliasTable(weights),
+                  Quantity::fromRaw(std::llround(rate / sum))});
+
+    if (level >= static_cast<int>(levels.size()))
+        levels.resize(level + 1);
+    levels[level] = built;
+
+    return built;
+}
@@ -0,0 +1,144 @@
+#ifndef TIERS_H
+#define TIERS_H
+
+#include "quantity.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// Revision History:
+/*      - 2026, Oct 19 - Initial creation of the classes.
+ */
+
+/// <summary>
+/// One produce rate type of a yield distribution. Its chance is its weight
+/// relative to the other tiers; the weight at proficiency level L is
+/// weight + gain * L, never below zero.
+/// </summary>
+struct Tier
+{
+    Quantity rate;      // produce rate of this tier
+    double weight;      // relative chance at proficiency level 0
+    double gain;        // change of the weight per proficiency level
+};
+
+/// <summary>
+/// Class representing a Walker/Vose alias table over a set of weights.
+/// Sampling costs one 64-bit random number and one comparison whatever the
+/// number of weights.
+/// Class Invariant: Every column holds a keep threshold in [0, 2^32] and an
+/// alias column.
+/// </summary>
+class AliasTable
+{
+private:
+    std::vector<unsigned long long> threshold;  // keep the column below this
+    std::vector<int> alias;                     // column used otherwise
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: weights must be non-negative with a positive sum.
+    /// Postcondition: A table sampling index i with probability
+    /// weights[i] / sum is created.
+    /// </summary>
+    explicit AliasTable(const std::vector<double>& weights);
+
+    /// <summary>
+    /// Sample function
+    /// Precondition: draw must be uniformly distributed over 64 bits.
+    /// Postcondition: The sampled index is returned. The high 32 bits pick
+    /// the column and the low 32 bits decide between it and its alias.
+    /// </summary>
+    int sample(unsigned long long draw) const;
+
+    /// <summary>
+    /// Get Size function
+    /// Precondition: None.
+    /// Postcondition: The number of weights is returned.
+    /// </summary>
+    int getSize() const;
+};
+
+/// <summary>
+/// Class representing the tier table of a yield distribution with any
+/// number of tiers.
+/// The alias table and expected rate of each proficiency level are built
+/// the first time a formula reaches that level and then shared by every
+/// formula using the table, so raising proficiency rebuilds nothing that was
+/// built before and sampling never builds anything.
+/// Class Invariant: There is at least one tier, every rate is non-negative
+/// and the level-0 weights have a positive sum.
+/// </summary>
+class TierTable
+{
+public:
+    /// <summary>
+    /// Sampling data of one proficiency level.
+    /// </summary>
+    struct Level
+    {
+        AliasTable sampler;     // picks a tier
+        Quantity expected;      // average produce rate
+    };
+
+private:
+    // holds the tiers
+    std::vector<Tier> tiers;
+
+    // guards levels; taken only when proficiency changes
+    mutable std::mutex building;
+
+    // holds the levels built so far, by proficiency level
+    mutable std::vector<std::shared_ptr<const Level>> levels;
+
+public:
+    /// <summary>
+    /// Constructor
+    /// Precondition: count must be positive, rates and weights must be
+    /// non-negative, and the weights must have a positive sum.
+    /// Postcondition: A table of the count tiers is created.
+    /// </summary>
+    TierTable(const Tier tiers[], int count);
+
+    /// <summary>
+    /// Standard function
+    /// Precondition: None.
+    /// Postcondition: The shared default table is returned: rates 0, 0.75,
+    /// 1 and 1.1 with chances 25%, 20%, 50% and 5% that shift by -5, -1, +3
+    /// and +3 points per proficiency level.
+    /// </summary>
+    static std::shared_ptr<const TierTable> standard();
+
+    /// <summary>
+    /// Get Size function
+    /// Precondition: None.
+    /// Postcondition: The number of tiers is returned.
+    /// </summary>
+    int getSize() const;
+
+    /// <summary>
+    /// Get Tier function
+    /// Precondition: index must be a valid tier index.
+    /// Postcondition: The tier at index is returned.
+    /// </summary>
+    const Tier& getTier(int index) const;
+
+    /// <summary>
+    /// Weight At function
+    /// Precondition: index must be a valid tier index, level non-negative.
+    /// Postcondition: The weight of the tier at the level is returned.
+    /// </summary>
+    double weightAt(int index, int level) const;
+
+    /// <summary>
+    /// At function
+    /// Precondition: level must be non-negative, and the weights at level
+    /// must have a positive sum.
+    /// Postcondition: The sampling data of level is returned, built on the
+    /// first request and shared afterwards.
+    /// </summary>
+    std::shared_ptr<const Level> at(int level) const;
+};
+
+#endif // !TIERS_H